@@ -0,0 +1,86 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Copyright 2023, Artem Savkov
+ */
+
+#ifndef _RP2040_OLED_ASYNC_H
+#define _RP2040_OLED_ASYNC_H
+
+#include <stdlib.h>
+
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+
+#include "include/rp2040-oled.h"
+
+/*
+ * Queue handling shared by the DMA transports. They differ in how the queue
+ * is sent, not in how it is set up.
+ */
+
+static inline bool rp2040_oled_async_busy(rp2040_oled_t *oled)
+{
+        return oled->async.busy;
+}
+
+static inline void rp2040_oled_async_wait(rp2040_oled_t *oled)
+{
+        while (rp2040_oled_async_busy(oled))
+                tight_loop_contents();
+}
+
+/*
+ * Claims the DMA channel on first use and routes its interrupt to handler
+ * through owners, the transport's channel to display table.
+ */
+static inline void rp2040_oled_async_claim_dma(rp2040_oled_t *oled, rp2040_oled_t **owners,
+                                               irq_handler_t handler, bool *installed)
+{
+        if (oled->async.dma_chan >= 0)
+                return;
+
+        oled->async.dma_chan = dma_claim_unused_channel(true);
+        owners[oled->async.dma_chan] = oled;
+
+        if (!*installed) {
+                irq_add_shared_handler(DMA_IRQ_0, handler,
+                                       PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+                irq_set_enabled(DMA_IRQ_0, true);
+                *installed = true;
+        }
+        dma_channel_set_irq0_enabled(oled->async.dma_chan, true);
+}
+
+/*
+ * Waits for the previous queue and allocates the queue on first use, sized
+ * for rp2040_oled_force_flush() with max_transfer splits (0 for none). False
+ * means flushing synchronously instead.
+ */
+static inline bool rp2040_oled_async_prepare(rp2040_oled_t *oled, uint16_t max_transfer)
+{
+        rp2040_oled_async_wait(oled);
+
+        if (!oled->async.buf) {
+                /* allocation-free mode without a queue flushes synchronously */
+                if (oled->arena)
+                        return false;
+
+                oled->async.size = RP2040_OLED_ASYNC_QUEUE_WORDS(
+                        (oled->height / PAGE_BITS) * (oled->width + 16u), max_transfer);
+                oled->async.buf = malloc(oled->async.size * sizeof(*oled->async.buf));
+                if (!oled->async.buf)
+                        return false;
+        }
+
+        return true;
+}
+
+/* Writes are queued from here until the transport submits the queue */
+static inline void rp2040_oled_async_record(rp2040_oled_t *oled)
+{
+        oled->async.len = 0;
+        oled->async.overflow = false;
+        oled->async.recording = true;
+}
+
+#endif /* _RP2040_OLED_ASYNC_H */
@@ -0,0 +1,394 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Copyright 2023, Artem Savkov
+ */
+
+#include "include/rp2040-oled.h"
+
+/*
+ * Both fonts are the 6x8 font of font.h with empty columns and rows trimmed
+ * off every glyph, the 16 row one scaled up twice. A degree sign is added for
+ * readouts.
+ */
+
+static const uint8_t rp2040_oled_font_8_data[] = {
+        0x06, 0x5f, 0x06, 0x07, 0x03, 0x00, 0x07, 0x03, 0x12, 0x3f, 0x12, 0x3f,
+        0x12, 0x24, 0x2b, 0x6a, 0x12, 0x63, 0x13, 0x08, 0x64, 0x63, 0x36, 0x49,
+        0x56, 0x20, 0x50, 0x07, 0x03, 0x3e, 0x41, 0x41, 0x3e, 0x04, 0x1f, 0x0e,
+        0x1f, 0x04, 0x04, 0x04, 0x1f, 0x04, 0x04, 0x07, 0x03, 0x01, 0x01, 0x01,
+        0x01, 0x01, 0x03, 0x03, 0x10, 0x08, 0x04, 0x02, 0x01, 0x3e, 0x51, 0x49,
+        0x45, 0x3e, 0x42, 0x7f, 0x40, 0x62, 0x51, 0x49, 0x49, 0x46, 0x22, 0x49,
+        0x49, 0x49, 0x36, 0x18, 0x14, 0x12, 0x7f, 0x10, 0x2f, 0x49, 0x49, 0x49,
+        0x31, 0x3c, 0x4a, 0x49, 0x49, 0x30, 0x01, 0x71, 0x09, 0x05, 0x03, 0x36,
+        0x49, 0x49, 0x49, 0x36, 0x06, 0x49, 0x49, 0x29, 0x1e, 0x1b, 0x1b, 0x3b,
+        0x1b, 0x08, 0x14, 0x22, 0x41, 0x09, 0x09, 0x09, 0x09, 0x09, 0x41, 0x22,
+        0x14, 0x08, 0x02, 0x01, 0x59, 0x09, 0x06, 0x3e, 0x41, 0x5d, 0x55, 0x1e,
+        0x7e, 0x11, 0x11, 0x11, 0x7e, 0x7f, 0x49, 0x49, 0x49, 0x36, 0x3e, 0x41,
+        0x41, 0x41, 0x22, 0x7f, 0x41, 0x41, 0x41, 0x3e, 0x7f, 0x49, 0x49, 0x49,
+        0x41, 0x7f, 0x09, 0x09, 0x09, 0x01, 0x3e, 0x41, 0x49, 0x49, 0x7a, 0x7f,
+        0x08, 0x08, 0x08, 0x7f, 0x41, 0x7f, 0x41, 0x30, 0x40, 0x40, 0x40, 0x3f,
+        0x7f, 0x08, 0x14, 0x22, 0x41, 0x7f, 0x40, 0x40, 0x40, 0x40, 0x7f, 0x02,
+        0x04, 0x02, 0x7f, 0x7f, 0x02, 0x04, 0x08, 0x7f, 0x3e, 0x41, 0x41, 0x41,
+        0x3e, 0x7f, 0x09, 0x09, 0x09, 0x06, 0x3e, 0x41, 0x51, 0x21, 0x5e, 0x7f,
+        0x09, 0x09, 0x19, 0x66, 0x26, 0x49, 0x49, 0x49, 0x32, 0x01, 0x01, 0x7f,
+        0x01, 0x01, 0x3f, 0x40, 0x40, 0x40, 0x3f, 0x1f, 0x20, 0x40, 0x20, 0x1f,
+        0x3f, 0x40, 0x3c, 0x40, 0x3f, 0x63, 0x14, 0x08, 0x14, 0x63, 0x07, 0x08,
+        0x70, 0x08, 0x07, 0x71, 0x49, 0x45, 0x43, 0x7f, 0x41, 0x41, 0x01, 0x02,
+        0x04, 0x08, 0x10, 0x41, 0x41, 0x7f, 0x04, 0x02, 0x01, 0x02, 0x04, 0x01,
+        0x01, 0x01, 0x01, 0x01, 0x03, 0x07, 0x08, 0x15, 0x15, 0x15, 0x1e, 0x7f,
+        0x44, 0x44, 0x44, 0x38, 0x0e, 0x11, 0x11, 0x11, 0x0a, 0x38, 0x44, 0x44,
+        0x44, 0x7f, 0x0e, 0x15, 0x15, 0x15, 0x02, 0x08, 0x7e, 0x09, 0x09, 0x06,
+        0x29, 0x29, 0x29, 0x1f, 0x7f, 0x04, 0x04, 0x78, 0x7d, 0x40, 0x40, 0x80,
+        0x84, 0x7d, 0x7f, 0x10, 0x28, 0x44, 0x7f, 0x40, 0x1f, 0x01, 0x06, 0x01,
+        0x1e, 0x1f, 0x01, 0x01, 0x1e, 0x0e, 0x11, 0x11, 0x11, 0x0e, 0x3f, 0x11,
+        0x11, 0x11, 0x0e, 0x0e, 0x11, 0x11, 0x11, 0x3f, 0x11, 0x1e, 0x11, 0x01,
+        0x02, 0x02, 0x15, 0x15, 0x15, 0x08, 0x02, 0x1f, 0x22, 0x12, 0x0f, 0x10,
+        0x08, 0x1f, 0x07, 0x08, 0x10, 0x08, 0x07, 0x0f, 0x18, 0x0c, 0x18, 0x0f,
+        0x1b, 0x04, 0x04, 0x1b, 0x27, 0x28, 0x18, 0x0f, 0x19, 0x15, 0x15, 0x13,
+        0x08, 0x3e, 0x41, 0x41, 0x77, 0x41, 0x41, 0x3e, 0x08, 0x02, 0x01, 0x02,
+        0x01, 0x3c, 0x26, 0x23, 0x26, 0x3c, 0x06, 0x09, 0x09, 0x06,
+};
+
+static const rp2040_oled_glyph_t rp2040_oled_font_8_glyphs[] = {
+        {    0,  0,  0,  0,  3 }, /*   */
+        {    0,  3,  7,  0,  4 }, /* ! */
+        {    3,  5,  3,  0,  6 }, /* " */
+        {    8,  5,  6,  1,  6 }, /* # */
+        {   13,  4,  7,  0,  5 }, /* $ */
+        {   17,  5,  7,  0,  6 }, /* % */
+        {   22,  5,  7,  0,  6 }, /* & */
+        {   27,  2,  3,  0,  3 }, /* ' */
+        {   29,  2,  7,  0,  3 }, /* ( */
+        {   31,  2,  7,  0,  3 }, /* ) */
+        {   33,  5,  5,  1,  6 }, /* asterisk */
+        {   38,  5,  5,  1,  6 }, /* + */
+        {   43,  2,  3,  5,  3 }, /* , */
+        {   45,  5,  1,  3,  6 }, /* - */
+        {   50,  2,  2,  5,  3 }, /* . */
+        {   52,  5,  5,  1,  6 }, /* / */
+        {   57,  5,  7,  0,  6 }, /* 0 */
+        {   62,  3,  7,  0,  4 }, /* 1 */
+        {   65,  5,  7,  0,  6 }, /* 2 */
+        {   70,  5,  7,  0,  6 }, /* 3 */
+        {   75,  5,  7,  0,  6 }, /* 4 */
+        {   80,  5,  7,  0,  6 }, /* 5 */
+        {   85,  5,  7,  0,  6 }, /* 6 */
+        {   90,  5,  7,  0,  6 }, /* 7 */
+        {   95,  5,  7,  0,  6 }, /* 8 */
+        {  100,  5,  7,  0,  6 }, /* 9 */
+        {  105,  2,  5,  2,  3 }, /* : */
+        {  107,  2,  6,  2,  3 }, /* ; */
+        {  109,  4,  7,  0,  5 }, /* < */
+        {  113,  5,  4,  2,  6 }, /* = */
+        {  118,  4,  7,  0,  5 }, /* > */
+        {  122,  5,  7,  0,  6 }, /* ? */
+        {  127,  5,  7,  0,  6 }, /* @ */
+        {  132,  5,  7,  0,  6 }, /* A */
+        {  137,  5,  7,  0,  6 }, /* B */
+        {  142,  5,  7,  0,  6 }, /* C */
+        {  147,  5,  7,  0,  6 }, /* D */
+        {  152,  5,  7,  0,  6 }, /* E */
+        {  157,  5,  7,  0,  6 }, /* F */
+        {  162,  5,  7,  0,  6 }, /* G */
+        {  167,  5,  7,  0,  6 }, /* H */
+        {  172,  3,  7,  0,  4 }, /* I */
+        {  175,  5,  7,  0,  6 }, /* J */
+        {  180,  5,  7,  0,  6 }, /* K */
+        {  185,  5,  7,  0,  6 }, /* L */
+        {  190,  5,  7,  0,  6 }, /* M */
+        {  195,  5,  7,  0,  6 }, /* N */
+        {  200,  5,  7,  0,  6 }, /* O */
+        {  205,  5,  7,  0,  6 }, /* P */
+        {  210,  5,  7,  0,  6 }, /* Q */
+        {  215,  5,  7,  0,  6 }, /* R */
+        {  220,  5,  7,  0,  6 }, /* S */
+        {  225,  5,  7,  0,  6 }, /* T */
+        {  230,  5,  7,  0,  6 }, /* U */
+        {  235,  5,  7,  0,  6 }, /* V */
+        {  240,  5,  7,  0,  6 }, /* W */
+        {  245,  5,  7,  0,  6 }, /* X */
+        {  250,  5,  7,  0,  6 }, /* Y */
+        {  255,  4,  7,  0,  5 }, /* Z */
+        {  259,  3,  7,  0,  4 }, /* [ */
+        {  262,  5,  5,  1,  6 }, /* \ */
+        {  267,  3,  7,  0,  4 }, /* ] */
+        {  270,  5,  3,  0,  6 }, /* ^ */
+        {  275,  5,  1,  7,  6 }, /* _ */
+        {  280,  2,  3,  0,  3 }, /* ` */
+        {  282,  5,  5,  2,  6 }, /* a */
+        {  287,  5,  7,  0,  6 }, /* b */
+        {  292,  5,  5,  2,  6 }, /* c */
+        {  297,  5,  7,  0,  6 }, /* d */
+        {  302,  5,  5,  2,  6 }, /* e */
+        {  307,  4,  7,  0,  5 }, /* f */
+        {  311,  5,  6,  2,  6 }, /* g */
+        {  316,  4,  7,  0,  5 }, /* h */
+        {  320,  2,  7,  0,  3 }, /* i */
+        {  322,  4,  8,  0,  5 }, /* j */
+        {  326,  4,  7,  0,  5 }, /* k */
+        {  330,  2,  7,  0,  3 }, /* l */
+        {  332,  5,  5,  2,  6 }, /* m */
+        {  337,  4,  5,  2,  5 }, /* n */
+        {  341,  5,  5,  2,  6 }, /* o */
+        {  346,  5,  6,  2,  6 }, /* p */
+        {  351,  5,  6,  2,  6 }, /* q */
+        {  356,  5,  5,  2,  6 }, /* r */
+        {  361,  5,  5,  2,  6 }, /* s */
+        {  366,  4,  6,  1,  5 }, /* t */
+        {  370,  4,  5,  2,  5 }, /* u */
+        {  374,  5,  5,  2,  6 }, /* v */
+        {  379,  5,  5,  2,  6 }, /* w */
+        {  384,  4,  5,  2,  5 }, /* x */
+        {  388,  4,  6,  2,  5 }, /* y */
+        {  392,  4,  5,  2,  5 }, /* z */
+        {  396,  4,  7,  0,  5 }, /* { */
+        {  400,  1,  7,  0,  2 }, /* | */
+        {  401,  4,  7,  0,  5 }, /* } */
+        {  405,  4,  2,  0,  5 }, /* ~ */
+        {  409,  5,  6,  0,  6 }, /* U+007F */
+        {  414,  4,  4,  0,  5 }, /* U+00B0 */
+};
+
+static const rp2040_oled_font_range_t rp2040_oled_font_8_ranges[] = {
+        { 0x20, 96, 0 },
+        { 0xb0, 1, 96 },
+};
+
+const rp2040_oled_font_t rp2040_oled_font_8 = {
+        .data        = rp2040_oled_font_8_data,
+        .glyphs      = rp2040_oled_font_8_glyphs,
+        .ranges      = rp2040_oled_font_8_ranges,
+        .range_count = 2,
+        .fallback    = '?',
+        .height      = 8,
+        .rle         = false,
+};
+
+static const uint8_t rp2040_oled_font_16_data[] = {
+        0x0b, 0x3c, 0x3c, 0xff, 0xff, 0x3c, 0x3c, 0x00, 0x00, 0x33, 0x33, 0x00,
+        0x00, 0x09, 0x3f, 0x3f, 0x0f, 0x0f, 0x00, 0x00, 0x3f, 0x3f, 0x0f, 0x0f,
+        0x13, 0x0c, 0x0c, 0xff, 0xff, 0x0c, 0x0c, 0xff, 0xff, 0x0c, 0x0c, 0x03,
+        0x03, 0x0f, 0x0f, 0x03, 0x03, 0x0f, 0x0f, 0x03, 0x03, 0x05, 0x30, 0x30,
+        0xcf, 0xcf, 0xcc, 0xcc, 0x85, 0x0c, 0x03, 0x3c, 0x3c, 0x03, 0x03, 0x83,
+        0x0f, 0x0b, 0xc0, 0xc0, 0x30, 0x30, 0x0f, 0x0f, 0x3c, 0x3c, 0x03, 0x03,
+        0x00, 0x00, 0x83, 0x3c, 0x05, 0x3c, 0x3c, 0xc3, 0xc3, 0x3c, 0x3c, 0x83,
+        0x00, 0x09, 0x0f, 0x0f, 0x30, 0x30, 0x33, 0x33, 0x0c, 0x0c, 0x33, 0x33,
+        0x03, 0x3f, 0x3f, 0x0f, 0x0f, 0x07, 0xfc, 0xfc, 0x03, 0x03, 0x0f, 0x0f,
+        0x30, 0x30, 0x07, 0x03, 0x03, 0xfc, 0xfc, 0x30, 0x30, 0x0f, 0x0f, 0x13,
+        0x30, 0x30, 0xff, 0xff, 0xfc, 0xfc, 0xff, 0xff, 0x30, 0x30, 0x00, 0x00,
+        0x03, 0x03, 0x00, 0x00, 0x03, 0x03, 0x00, 0x00, 0x83, 0x30, 0x01, 0xff,
+        0xff, 0x83, 0x30, 0x83, 0x00, 0x01, 0x03, 0x03, 0x83, 0x00, 0x03, 0x3f,
+        0x3f, 0x0f, 0x0f, 0x89, 0x03, 0x83, 0x0f, 0x07, 0x00, 0x00, 0xc0, 0xc0,
+        0x30, 0x30, 0x0c, 0x0c, 0x83, 0x03, 0x87, 0x00, 0x0d, 0xfc, 0xfc, 0x03,
+        0x03, 0xc3, 0xc3, 0x33, 0x33, 0xfc, 0xfc, 0x0f, 0x0f, 0x33, 0x33, 0x83,
+        0x30, 0x01, 0x0f, 0x0f, 0x0b, 0x0c, 0x0c, 0xff, 0xff, 0x00, 0x00, 0x30,
+        0x30, 0x3f, 0x3f, 0x30, 0x30, 0x03, 0x0c, 0x0c, 0x03, 0x03, 0x83, 0xc3,
+        0x83, 0x3c, 0x01, 0x33, 0x33, 0x85, 0x30, 0x01, 0x0c, 0x0c, 0x85, 0xc3,
+        0x03, 0x3c, 0x3c, 0x0c, 0x0c, 0x85, 0x30, 0x01, 0x0f, 0x0f, 0x09, 0xc0,
+        0xc0, 0x30, 0x30, 0x0c, 0x0c, 0xff, 0xff, 0x00, 0x00, 0x85, 0x03, 0x03,
+        0x3f, 0x3f, 0x03, 0x03, 0x01, 0xff, 0xff, 0x85, 0xc3, 0x03, 0x03, 0x03,
+        0x0c, 0x0c, 0x85, 0x30, 0x01, 0x0f, 0x0f, 0x03, 0xf0, 0xf0, 0xcc, 0xcc,
+        0x83, 0xc3, 0x03, 0x00, 0x00, 0x0f, 0x0f, 0x85, 0x30, 0x01, 0x0f, 0x0f,
+        0x83, 0x03, 0x09, 0xc3, 0xc3, 0x33, 0x33, 0x0f, 0x0f, 0x00, 0x00, 0x3f,
+        0x3f, 0x85, 0x00, 0x01, 0x3c, 0x3c, 0x85, 0xc3, 0x03, 0x3c, 0x3c, 0x0f,
+        0x0f, 0x85, 0x30, 0x01, 0x0f, 0x0f, 0x01, 0x3c, 0x3c, 0x85, 0xc3, 0x03,
+        0xfc, 0xfc, 0x00, 0x00, 0x83, 0x30, 0x03, 0x0c, 0x0c, 0x03, 0x03, 0x83,
+        0xcf, 0x83, 0x03, 0x83, 0xcf, 0x03, 0x0f, 0x0f, 0x03, 0x03, 0x0f, 0xc0,
+        0xc0, 0x30, 0x30, 0x0c, 0x0c, 0x03, 0x03, 0x00, 0x00, 0x03, 0x03, 0x0c,
+        0x0c, 0x30, 0x30, 0x89, 0xc3, 0x0f, 0x03, 0x03, 0x0c, 0x0c, 0x30, 0x30,
+        0xc0, 0xc0, 0x30, 0x30, 0x0c, 0x0c, 0x03, 0x03, 0x00, 0x00, 0x03, 0x0c,
+        0x0c, 0x03, 0x03, 0x83, 0xc3, 0x01, 0x3c, 0x3c, 0x83, 0x00, 0x01, 0x33,
+        0x33, 0x83, 0x00, 0x0d, 0xfc, 0xfc, 0x03, 0x03, 0xf3, 0xf3, 0x33, 0x33,
+        0xfc, 0xfc, 0x0f, 0x0f, 0x30, 0x30, 0x83, 0x33, 0x01, 0x03, 0x03, 0x01,
+        0xfc, 0xfc, 0x85, 0x03, 0x03, 0xfc, 0xfc, 0x3f, 0x3f, 0x85, 0x03, 0x01,
+        0x3f, 0x3f, 0x01, 0xff, 0xff, 0x85, 0xc3, 0x03, 0x3c, 0x3c, 0x3f, 0x3f,
+        0x85, 0x30, 0x01, 0x0f, 0x0f, 0x01, 0xfc, 0xfc, 0x85, 0x03, 0x03, 0x0c,
+        0x0c, 0x0f, 0x0f, 0x85, 0x30, 0x01, 0x0c, 0x0c, 0x01, 0xff, 0xff, 0x85,
+        0x03, 0x03, 0xfc, 0xfc, 0x3f, 0x3f, 0x85, 0x30, 0x01, 0x0f, 0x0f, 0x01,
+        0xff, 0xff, 0x85, 0xc3, 0x03, 0x03, 0x03, 0x3f, 0x3f, 0x87, 0x30, 0x01,
+        0xff, 0xff, 0x85, 0xc3, 0x03, 0x03, 0x03, 0x3f, 0x3f, 0x87, 0x00, 0x03,
+        0xfc, 0xfc, 0x03, 0x03, 0x83, 0xc3, 0x03, 0xcc, 0xcc, 0x0f, 0x0f, 0x85,
+        0x30, 0x01, 0x3f, 0x3f, 0x01, 0xff, 0xff, 0x85, 0xc0, 0x03, 0xff, 0xff,
+        0x3f, 0x3f, 0x85, 0x00, 0x01, 0x3f, 0x3f, 0x0b, 0x03, 0x03, 0xff, 0xff,
+        0x03, 0x03, 0x30, 0x30, 0x3f, 0x3f, 0x30, 0x30, 0x87, 0x00, 0x03, 0xff,
+        0xff, 0x0f, 0x0f, 0x85, 0x30, 0x01, 0x0f, 0x0f, 0x13, 0xff, 0xff, 0xc0,
+        0xc0, 0x30, 0x30, 0x0c, 0x0c, 0x03, 0x03, 0x3f, 0x3f, 0x00, 0x00, 0x03,
+        0x03, 0x0c, 0x0c, 0x30, 0x30, 0x01, 0xff, 0xff, 0x87, 0x00, 0x01, 0x3f,
+        0x3f, 0x87, 0x30, 0x0b, 0xff, 0xff, 0x0c, 0x0c, 0x30, 0x30, 0x0c, 0x0c,
+        0xff, 0xff, 0x3f, 0x3f, 0x85, 0x00, 0x01, 0x3f, 0x3f, 0x0b, 0xff, 0xff,
+        0x0c, 0x0c, 0x30, 0x30, 0xc0, 0xc0, 0xff, 0xff, 0x3f, 0x3f, 0x85, 0x00,
+        0x01, 0x3f, 0x3f, 0x01, 0xfc, 0xfc, 0x85, 0x03, 0x03, 0xfc, 0xfc, 0x0f,
+        0x0f, 0x85, 0x30, 0x01, 0x0f, 0x0f, 0x01, 0xff, 0xff, 0x85, 0xc3, 0x03,
+        0x3c, 0x3c, 0x3f, 0x3f, 0x87, 0x00, 0x01, 0xfc, 0xfc, 0x85, 0x03, 0x0b,
+        0xfc, 0xfc, 0x0f, 0x0f, 0x30, 0x30, 0x33, 0x33, 0x0c, 0x0c, 0x33, 0x33,
+        0x01, 0xff, 0xff, 0x85, 0xc3, 0x03, 0x3c, 0x3c, 0x3f, 0x3f, 0x83, 0x00,
+        0x03, 0x03, 0x03, 0x3c, 0x3c, 0x01, 0x3c, 0x3c, 0x85, 0xc3, 0x83, 0x0c,
+        0x85, 0x30, 0x01, 0x0f, 0x0f, 0x83, 0x03, 0x01, 0xff, 0xff, 0x83, 0x03,
+        0x83, 0x00, 0x01, 0x3f, 0x3f, 0x83, 0x00, 0x01, 0xff, 0xff, 0x85, 0x00,
+        0x03, 0xff, 0xff, 0x0f, 0x0f, 0x85, 0x30, 0x01, 0x0f, 0x0f, 0x01, 0xff,
+        0xff, 0x85, 0x00, 0x0b, 0xff, 0xff, 0x03, 0x03, 0x0c, 0x0c, 0x30, 0x30,
+        0x0c, 0x0c, 0x03, 0x03, 0x13, 0xff, 0xff, 0x00, 0x00, 0xf0, 0xf0, 0x00,
+        0x00, 0xff, 0xff, 0x0f, 0x0f, 0x30, 0x30, 0x0f, 0x0f, 0x30, 0x30, 0x0f,
+        0x0f, 0x13, 0x0f, 0x0f, 0x30, 0x30, 0xc0, 0xc0, 0x30, 0x30, 0x0f, 0x0f,
+        0x3c, 0x3c, 0x03, 0x03, 0x00, 0x00, 0x03, 0x03, 0x3c, 0x3c, 0x09, 0x3f,
+        0x3f, 0xc0, 0xc0, 0x00, 0x00, 0xc0, 0xc0, 0x3f, 0x3f, 0x83, 0x00, 0x01,
+        0x3f, 0x3f, 0x83, 0x00, 0x09, 0x03, 0x03, 0xc3, 0xc3, 0x33, 0x33, 0x0f,
+        0x0f, 0x3f, 0x3f, 0x85, 0x30, 0x01, 0xff, 0xff, 0x83, 0x03, 0x01, 0x3f,
+        0x3f, 0x83, 0x30, 0x07, 0x03, 0x03, 0x0c, 0x0c, 0x30, 0x30, 0xc0, 0xc0,
+        0x89, 0x00, 0x01, 0x03, 0x03, 0x83, 0x03, 0x01, 0xff, 0xff, 0x83, 0x30,
+        0x01, 0x3f, 0x3f, 0x09, 0x30, 0x30, 0x0c, 0x0c, 0x03, 0x03, 0x0c, 0x0c,
+        0x30, 0x30, 0x89, 0x03, 0x03, 0x0f, 0x0f, 0x3f, 0x3f, 0x01, 0xc0, 0xc0,
+        0x85, 0x33, 0x03, 0xfc, 0xfc, 0x00, 0x00, 0x87, 0x03, 0x01, 0xff, 0xff,
+        0x85, 0x30, 0x03, 0xc0, 0xc0, 0x3f, 0x3f, 0x85, 0x30, 0x01, 0x0f, 0x0f,
+        0x01, 0xfc, 0xfc, 0x85, 0x03, 0x03, 0xcc, 0xcc, 0x00, 0x00, 0x85, 0x03,
+        0x01, 0x00, 0x00, 0x01, 0xc0, 0xc0, 0x85, 0x30, 0x03, 0xff, 0xff, 0x0f,
+        0x0f, 0x85, 0x30, 0x01, 0x3f, 0x3f, 0x01, 0xfc, 0xfc, 0x85, 0x33, 0x03,
+        0x0c, 0x0c, 0x00, 0x00, 0x85, 0x03, 0x01, 0x00, 0x00, 0x03, 0xc0, 0xc0,
+        0xfc, 0xfc, 0x83, 0xc3, 0x03, 0x00, 0x00, 0x3f, 0x3f, 0x83, 0x00, 0x01,
+        0x3c, 0x3c, 0x85, 0xc3, 0x03, 0xff, 0xff, 0x00, 0x00, 0x85, 0x0c, 0x01,
+        0x03, 0x03, 0x01, 0xff, 0xff, 0x83, 0x30, 0x03, 0xc0, 0xc0, 0x3f, 0x3f,
+        0x83, 0x00, 0x01, 0x3f, 0x3f, 0x07, 0xf3, 0xf3, 0x00, 0x00, 0x3f, 0x3f,
+        0x30, 0x30, 0x83, 0x00, 0x05, 0x30, 0x30, 0xf3, 0xf3, 0x30, 0x30, 0x83,
+        0xc0, 0x01, 0x3f, 0x3f, 0x0f, 0xff, 0xff, 0x00, 0x00, 0xc0, 0xc0, 0x30,
+        0x30, 0x3f, 0x3f, 0x03, 0x03, 0x0c, 0x0c, 0x30, 0x30, 0x07, 0xff, 0xff,
+        0x00, 0x00, 0x3f, 0x3f, 0x30, 0x30, 0x0b, 0xff, 0xff, 0x03, 0x03, 0x3c,
+        0x3c, 0x03, 0x03, 0xfc, 0xfc, 0x03, 0x03, 0x85, 0x00, 0x01, 0x03, 0x03,
+        0x01, 0xff, 0xff, 0x83, 0x03, 0x03, 0xfc, 0xfc, 0x03, 0x03, 0x83, 0x00,
+        0x01, 0x03, 0x03, 0x01, 0xfc, 0xfc, 0x85, 0x03, 0x03, 0xfc, 0xfc, 0x00,
+        0x00, 0x85, 0x03, 0x01, 0x00, 0x00, 0x01, 0xff, 0xff, 0x85, 0x03, 0x03,
+        0xfc, 0xfc, 0x0f, 0x0f, 0x85, 0x03, 0x01, 0x00, 0x00, 0x01, 0xfc, 0xfc,
+        0x85, 0x03, 0x03, 0xff, 0xff, 0x00, 0x00, 0x85, 0x03, 0x01, 0x0f, 0x0f,
+        0x03, 0x03, 0x03, 0xfc, 0xfc, 0x83, 0x03, 0x01, 0x0c, 0x0c, 0x85, 0x03,
+        0x83, 0x00, 0x01, 0x0c, 0x0c, 0x85, 0x33, 0x03, 0xc0, 0xc0, 0x00, 0x00,
+        0x85, 0x03, 0x01, 0x00, 0x00, 0x03, 0x0c, 0x0c, 0xff, 0xff, 0x83, 0x0c,
+        0x07, 0x00, 0x00, 0x03, 0x03, 0x0c, 0x0c, 0x03, 0x03, 0x0f, 0xff, 0xff,
+        0x00, 0x00, 0xc0, 0xc0, 0xff, 0xff, 0x00, 0x00, 0x03, 0x03, 0x00, 0x00,
+        0x03, 0x03, 0x09, 0x3f, 0x3f, 0xc0, 0xc0, 0x00, 0x00, 0xc0, 0xc0, 0x3f,
+        0x3f, 0x83, 0x00, 0x01, 0x03, 0x03, 0x83, 0x00, 0x13, 0xff, 0xff, 0xc0,
+        0xc0, 0xf0, 0xf0, 0xc0, 0xc0, 0xff, 0xff, 0x00, 0x00, 0x03, 0x03, 0x00,
+        0x00, 0x03, 0x03, 0x00, 0x00, 0x01, 0xcf, 0xcf, 0x83, 0x30, 0x03, 0xcf,
+        0xcf, 0x03, 0x03, 0x83, 0x00, 0x01, 0x03, 0x03, 0x01, 0x3f, 0x3f, 0x83,
+        0xc0, 0x01, 0xff, 0xff, 0x83, 0x0c, 0x03, 0x03, 0x03, 0x00, 0x00, 0x01,
+        0xc3, 0xc3, 0x83, 0x33, 0x01, 0x0f, 0x0f, 0x87, 0x03, 0x03, 0xc0, 0xc0,
+        0xfc, 0xfc, 0x83, 0x03, 0x03, 0x00, 0x00, 0x0f, 0x0f, 0x83, 0x30, 0x83,
+        0x3f, 0x83, 0x03, 0x03, 0xfc, 0xfc, 0xc0, 0xc0, 0x83, 0x30, 0x03, 0x0f,
+        0x0f, 0x00, 0x00, 0x07, 0x0c, 0x0c, 0x03, 0x03, 0x0c, 0x0c, 0x03, 0x03,
+        0x0b, 0xf0, 0xf0, 0x3c, 0x3c, 0x0f, 0x0f, 0x3c, 0x3c, 0xf0, 0xf0, 0x0f,
+        0x0f, 0x85, 0x0c, 0x01, 0x0f, 0x0f, 0x01, 0x3c, 0x3c, 0x83, 0xc3, 0x01,
+        0x3c, 0x3c,
+};
+
+static const rp2040_oled_glyph_t rp2040_oled_font_16_glyphs[] = {
+        {    0,  0,  0,  0,  6 }, /*   */
+        {    0,  6, 14,  0,  8 }, /* ! */
+        {   13, 10,  6,  0, 12 }, /* " */
+        {   24, 10, 12,  2, 12 }, /* # */
+        {   45,  8, 14,  0, 10 }, /* $ */
+        {   59, 10, 14,  0, 12 }, /* % */
+        {   76, 10, 14,  0, 12 }, /* & */
+        {   96,  4,  6,  0,  6 }, /* ' */
+        {  101,  4, 14,  0,  6 }, /* ( */
+        {  110,  4, 14,  0,  6 }, /* ) */
+        {  119, 10, 10,  2, 12 }, /* asterisk */
+        {  140, 10, 10,  2, 12 }, /* + */
+        {  154,  4,  6, 10,  6 }, /* , */
+        {  159, 10,  2,  6, 12 }, /* - */
+        {  161,  4,  4, 10,  6 }, /* . */
+        {  163, 10, 10,  2, 12 }, /* / */
+        {  176, 10, 14,  0, 12 }, /* 0 */
+        {  196,  6, 14,  0,  8 }, /* 1 */
+        {  209, 10, 14,  0, 12 }, /* 2 */
+        {  223, 10, 14,  0, 12 }, /* 3 */
+        {  238, 10, 14,  0, 12 }, /* 4 */
+        {  256, 10, 14,  0, 12 }, /* 5 */
+        {  271, 10, 14,  0, 12 }, /* 6 */
+        {  288, 10, 14,  0, 12 }, /* 7 */
+        {  303, 10, 14,  0, 12 }, /* 8 */
+        {  318, 10, 14,  0, 12 }, /* 9 */
+        {  335,  4, 10,  4,  6 }, /* : */
+        {  339,  4, 12,  4,  6 }, /* ; */
+        {  346,  8, 14,  0, 10 }, /* < */
+        {  363, 10,  8,  4, 12 }, /* = */
+        {  365,  8, 14,  0, 10 }, /* > */
+        {  382, 10, 14,  0, 12 }, /* ? */
+        {  399, 10, 14,  0, 12 }, /* @ */
+        {  419, 10, 14,  0, 12 }, /* A */
+        {  434, 10, 14,  0, 12 }, /* B */
+        {  449, 10, 14,  0, 12 }, /* C */
+        {  464, 10, 14,  0, 12 }, /* D */
+        {  479, 10, 14,  0, 12 }, /* E */
+        {  491, 10, 14,  0, 12 }, /* F */
+        {  503, 10, 14,  0, 12 }, /* G */
+        {  520, 10, 14,  0, 12 }, /* H */
+        {  535,  6, 14,  0,  8 }, /* I */
+        {  548, 10, 14,  0, 12 }, /* J */
+        {  560, 10, 14,  0, 12 }, /* K */
+        {  581, 10, 14,  0, 12 }, /* L */
+        {  591, 10, 14,  0, 12 }, /* M */
+        {  609, 10, 14,  0, 12 }, /* N */
+        {  627, 10, 14,  0, 12 }, /* O */
+        {  642, 10, 14,  0, 12 }, /* P */
+        {  654, 10, 14,  0, 12 }, /* Q */
+        {  672, 10, 14,  0, 12 }, /* R */
+        {  689, 10, 14,  0, 12 }, /* S */
+        {  701, 10, 14,  0, 12 }, /* T */
+        {  715, 10, 14,  0, 12 }, /* U */
+        {  730, 10, 14,  0, 12 }, /* V */
+        {  748, 10, 14,  0, 12 }, /* W */
+        {  769, 10, 14,  0, 12 }, /* X */
+        {  790, 10, 14,  0, 12 }, /* Y */
+        {  808,  8, 14,  0, 10 }, /* Z */
+        {  821,  6, 14,  0,  8 }, /* [ */
+        {  831, 10, 10,  2, 12 }, /* \ */
+        {  845,  6, 14,  0,  8 }, /* ] */
+        {  855, 10,  6,  0, 12 }, /* ^ */
+        {  866, 10,  2, 14, 12 }, /* _ */
+        {  868,  4,  6,  0,  6 }, /* ` */
+        {  873, 10, 10,  4, 12 }, /* a */
+        {  885, 10, 14,  0, 12 }, /* b */
+        {  900, 10, 10,  4, 12 }, /* c */
+        {  915, 10, 14,  0, 12 }, /* d */
+        {  930, 10, 10,  4, 12 }, /* e */
+        {  945,  8, 14,  0, 10 }, /* f */
+        {  959, 10, 12,  4, 12 }, /* g */
+        {  974,  8, 14,  0, 10 }, /* h */
+        {  989,  4, 14,  0,  6 }, /* i */
+        {  998,  8, 16,  0, 10 }, /* j */
+        { 1012,  8, 14,  0, 10 }, /* k */
+        { 1029,  4, 14,  0,  6 }, /* l */
+        { 1038, 10, 10,  4, 12 }, /* m */
+        { 1056,  8, 10,  4, 10 }, /* n */
+        { 1071, 10, 10,  4, 12 }, /* o */
+        { 1086, 10, 12,  4, 12 }, /* p */
+        { 1101, 10, 12,  4, 12 }, /* q */
+        { 1116, 10, 10,  4, 12 }, /* r */
+        { 1130, 10, 10,  4, 12 }, /* s */
+        { 1145,  8, 12,  2, 10 }, /* t */
+        { 1161,  8, 10,  4, 10 }, /* u */
+        { 1178, 10, 10,  4, 12 }, /* v */
+        { 1196, 10, 10,  4, 12 }, /* w */
+        { 1217,  8, 10,  4, 10 }, /* x */
+        { 1232,  8, 12,  4, 10 }, /* y */
+        { 1247,  8, 10,  4, 10 }, /* z */
+        { 1257,  8, 14,  0, 10 }, /* { */
+        { 1271,  2, 14,  0,  4 }, /* | */
+        { 1273,  8, 14,  0, 10 }, /* } */
+        { 1287,  8,  4,  0, 10 }, /* ~ */
+        { 1296, 10, 12,  0, 12 }, /* U+007F */
+        { 1314,  8,  8,  0, 10 }, /* U+00B0 */
+};
+
+static const rp2040_oled_font_range_t rp2040_oled_font_16_ranges[] = {
+        { 0x20, 96, 0 },
+        { 0xb0, 1, 96 },
+};
+
+const rp2040_oled_font_t rp2040_oled_font_16 = {
+        .data        = rp2040_oled_font_16_data,
+        .glyphs      = rp2040_oled_font_16_glyphs,
+        .ranges      = rp2040_oled_font_16_ranges,
+        .range_count = 2,
+        .fallback    = '?',
+        .height      = 16,
+        .rle         = true,
+};
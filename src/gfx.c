@@ -6,148 +6,375 @@
 #include <stdlib.h>
 #include <string.h>
 
-#include "i2c.h"
+#include "gfx.h"
+#include "multicore.h"
+#include "transport.h"
 #include "font.h"
+#include "include/rp2040-oled-inline.h"
 
-static uint8_t *rp2040_oled_alloc_data_buf(size_t size)
+void rp2040_oled_get_offset(rp2040_oled_t *oled, uint8_t *x, uint8_t *page)
 {
-        uint8_t *buf;
+        *x = 0;
+        *page = 0;
 
-        buf = malloc(size + 1);
-        memset(buf, 0x00, size + 1);
-        buf[0] = OLED_CB_DATA_BIT;
+        if (oled->size == OLED_64x32) {
+                *x = 32;
+                if (oled->flip == 0)
+                        *page = 4;
+        } else if (oled->size == OLED_132x64) {
+                *x = 2;
+        } else if (oled->size == OLED_96x16) {
+                if (oled->flip == 0)
+                        *page = 2;
+                else
+                        *x = 32;
+        } else if (oled->size == OLED_72x40) {
+                *x = 28;
+                if (oled->flip == 0)
+                        *page = 3;
+        }
+}
 
-        return buf + 1;
+static bool rp2040_oled_is_sh1107(rp2040_oled_t *oled)
+{
+        return oled->type == OLED_SH1107_3C || oled->type == OLED_SH1107_3D;
 }
 
-static void rp2040_oled_free_data_buf(uint8_t *buf)
+/* pages of display RAM, the start line wraps around within them */
+static uint8_t rp2040_oled_ram_pages(rp2040_oled_t *oled)
 {
-        free(buf - 1);
+        return rp2040_oled_is_sh1107(oled) ? 16 : 8;
 }
 
-static bool rp2040_oled_set_position(rp2040_oled_t *oled, uint8_t x, uint8_t y, bool render)
+/* RAM page that shows up as page of the screen at the current start line */
+static uint8_t rp2040_oled_ram_page(rp2040_oled_t *oled, uint8_t page)
 {
-        uint8_t buf[4];
+        return (page + oled->page_offset + oled->scroll_page) % rp2040_oled_ram_pages(oled);
+}
 
-        y /= PAGE_BITS;
+/*
+ * Points the controller at column x of page. In horizontal addressing mode the
+ * write window is also limited to width columns by pages pages, data then
+ * wraps from the end of one page of the window to the start of the next.
+ */
+static bool rp2040_oled_send_position(rp2040_oled_t *oled, uint8_t x, uint8_t page,
+                                      uint8_t width, uint8_t pages)
+{
+        uint8_t buf[7];
 
-        if (oled->size == OLED_64x32) {
-                x += 32;
-                if (oled->flip == 0)
-                        y += 4;
-        } else if (oled->size == OLED_132x64) {
-                x += 2;
-        } else if (oled->size == OLED_96x16) {
-                if (oled->flip == 0)
-                        y += 2;
-                else
-                        x += 32;
-        } else if (oled->size == OLED_72x40) {
-                x += 28;
-                if (oled->flip == 0)
-                        y += 3;
+        x += oled->column_offset;
+        page = rp2040_oled_ram_page(oled, page);
+
+        if (oled->use_horizontal_addr) {
+                buf[0] = 0x00;
+                buf[1] = OLED_CMD_SET_SSD1306_COLUMN_RANGE;
+                buf[2] = x;
+                buf[3] = x + width - 1;
+                buf[4] = OLED_CMD_SET_SSD1306_PAGE_RANGE;
+                buf[5] = page;
+                buf[6] = page + pages - 1;
+
+                return rp2040_oled_bus_write(oled, buf, 7) == 7;
         }
 
+        buf[0] = 0x00;
+        buf[1] = OLED_CMD_SET_PAGE_ADDR | page;
+        buf[2] = OLED_CMD_SET_LC_ADDR | (x & 0x0f);
+        buf[3] = OLED_CMD_SET_HC_ADDR | (x >> 4);
+
+        return rp2040_oled_bus_write(oled, buf, 4) == 4;
+}
+
+static bool rp2040_oled_set_position(rp2040_oled_t *oled, uint8_t x, uint8_t y, bool render)
+{
+        y /= PAGE_BITS;
+
         oled->cursor.x = x;
         oled->cursor.y = y;
 
         if (!render)
                 return true;
 
-        buf[0] = 0x00;
-        buf[1] = OLED_CMD_SET_PAGE_ADDR | y;
-        buf[2] = OLED_CMD_SET_LC_ADDR | (x & 0x0f);
-        buf[3] = OLED_CMD_SET_HC_ADDR | (x >> 4);
-
-        return rp2040_i2c_write(oled, buf, sizeof(buf)) == sizeof(buf);
+        return rp2040_oled_send_position(oled, x, y, oled->width - x, 1);
 }
 
-static bool rp2040_oled_render_gdram(rp2040_oled_t *oled, uint8_t x, uint8_t y,
-                                     size_t gdram_offset, uint8_t size)
+/*
+ * Sends width columns of pages [y, y + pages) starting at column x. src is
+ * where the up to date contents are, they are copied to gdram first if it is
+ * not gdram itself. More than one page at a time needs horizontal addressing.
+ */
+static bool rp2040_oled_render_rect(rp2040_oled_t *oled, const uint8_t *src, uint8_t x,
+                                    uint8_t y, uint8_t width, uint8_t pages)
 {
-        uint8_t *buf = NULL;
+        size_t gdram_offset = x + (y * oled->width);
+        uint8_t first = rp2040_oled_ram_page(oled, y);
 
-        if (oled->use_doublebuf)
-                memcpy(oled->gdram + gdram_offset, oled->dirty_buf + gdram_offset,
-                       size);
+        /* a window can't wrap around the end of RAM, split it where it would */
+        if (first + pages > rp2040_oled_ram_pages(oled)) {
+                uint8_t head = rp2040_oled_ram_pages(oled) - first;
 
-        buf = rp2040_oled_alloc_data_buf(size);
-        memcpy(buf, oled->gdram + gdram_offset, size);
+                return rp2040_oled_render_rect(oled, src, x, y, width, head) &&
+                       rp2040_oled_render_rect(oled, src, x, y + head, width, pages - head);
+        }
 
-        if (!rp2040_oled_set_position(oled, x, y * PAGE_BITS, true)) {
-                return false;
+        if (src != oled->gdram) {
+                for (uint8_t page = 0; page < pages; page++)
+                        memcpy(oled->gdram + gdram_offset + page * oled->width,
+                               src + gdram_offset + page * oled->width, width);
         }
-        if (rp2040_i2c_write(oled, buf - 1, size + 1) != size + 1) {
-                rp2040_oled_free_data_buf(buf);
+
+        if (!rp2040_oled_send_position(oled, x, y, width, pages))
                 return false;
+
+        return rp2040_oled_bus_write_data(oled, oled->gdram + gdram_offset, width, pages,
+                                          oled->width) == width * pages;
+}
+
+static uint8_t rp2040_oled_position_cost(rp2040_oled_t *oled)
+{
+        return oled->transport->txn_cost + (oled->use_horizontal_addr ? 6 : 3);
+}
+
+/*
+ * Every dirty run costs a position transaction and a data transaction. Clean
+ * gaps up to that cost are cheaper to resend than to skip.
+ */
+static uint8_t rp2040_oled_merge_gap(rp2040_oled_t *oled)
+{
+        return rp2040_oled_position_cost(oled) + oled->transport->txn_cost;
+}
+
+typedef struct {
+        const uint8_t *src;
+        /* pages to look at and the columns within them, the rest is clean */
+        uint16_t      pages;
+        const rp2040_oled_span_t *spans;
+        uint8_t       y;
+        uint8_t       x;
+        uint8_t       width;
+        uint8_t       gap;
+        /* only add up cost and bounds of the runs instead of sending them */
+        bool          dry;
+        size_t        cost;
+        uint8_t       x0, x1, y0, y1;
+} rp2040_oled_run_t;
+
+static void rp2040_oled_end_run(rp2040_oled_t *oled, rp2040_oled_run_t *run)
+{
+        if (run->width == 0)
+                return;
+
+        if (!run->dry) {
+                rp2040_oled_render_rect(oled, run->src, run->x, run->y, run->width, 1);
+        } else {
+                if (run->cost == 0) {
+                        run->x0 = run->x;
+                        run->y0 = run->y;
+                        run->x1 = run->x + run->width - 1;
+                } else {
+                        if (run->x < run->x0)
+                                run->x0 = run->x;
+                        if (run->x + run->width - 1 > run->x1)
+                                run->x1 = run->x + run->width - 1;
+                }
+                run->y1 = run->y;
+                run->cost += rp2040_oled_merge_gap(oled) + run->width;
         }
 
-        rp2040_oled_free_data_buf(buf);
-        return true;
+        run->width = 0;
 }
 
-bool rp2040_oled_flush(rp2040_oled_t *oled)
+static void rp2040_oled_add_run(rp2040_oled_t *oled, rp2040_oled_run_t *run, uint8_t x,
+                                uint8_t width)
 {
-        if (!oled->is_dirty)
-                return true;
+        if (run->width != 0 && x - (run->x + run->width) <= run->gap) {
+                run->width = x + width - run->x;
+                return;
+        }
+
+        rp2040_oled_end_run(oled, run);
+        run->x = x;
+        run->width = width;
+}
+
+/* Clears the bitmap bytes covered by the dirty spans, nothing else is set */
+static void rp2040_oled_clear_dirty(rp2040_oled_t *oled)
+{
+        uint8_t stride = (oled->width + 7) / 8;
+
+        for (uint8_t y = 0; y < oled->height / PAGE_BITS; y++) {
+                uint8_t x0 = oled->dirty_spans[y].x0 / 8;
+
+                if (oled->dirty_pages & 1u << y)
+                        memset(oled->dirty_buf + y * stride + x0, 0x00,
+                               oled->dirty_spans[y].x1 / 8 - x0 + 1);
+        }
+}
+
+/*
+ * Word access to byte buffers. Going through memcpy keeps it within the
+ * aliasing rules, it still is a single load once alignment is known.
+ */
+static inline uint32_t rp2040_oled_load32(const uint8_t *p)
+{
+        uint32_t word;
 
+        memcpy(&word, p, sizeof(word));
+        return word;
+}
+
+static inline void rp2040_oled_store32(uint8_t *p, uint32_t word)
+{
+        memcpy(p, &word, sizeof(word));
+}
+
+/*
+ * Compares a word at a time and only looks at single bytes within words that
+ * differ, so clean stretches cost a load pair per four columns.
+ */
+static void rp2040_oled_scan_diff(rp2040_oled_t *oled, rp2040_oled_run_t *run)
+{
         for (uint8_t y = 0; y < oled->height / PAGE_BITS; y++) {
+                const uint8_t *front = oled->gdram + y * oled->width;
+                const uint8_t *back = run->src + y * oled->width;
+                bool aligned = !(((uintptr_t)front | (uintptr_t)back) & 3);
+                uint8_t xend = run->spans[y].x1 + 1;
                 uint8_t xstart = 0;
                 uint8_t width = 0;
 
-                if (oled->use_doublebuf) {
-                        for (uint8_t x = 0; x < oled->width; x++) {
-                                if (*(oled->gdram + (y * oled->width + x)) != *(oled->dirty_buf + (y * oled->width + x))) {
-                                        if (width == 0)
-                                                xstart = x;
-                                        width++;
-                                } else {
-                                        if (width != 0) {
-                                                size_t gdram_offset = xstart + (y * oled->width);
-                                                rp2040_oled_render_gdram(oled, xstart, y, gdram_offset, width);
+                if (!(run->pages & 1u << y))
+                        continue;
 
-                                                width = 0;
-                                        }
-                                }
+                run->y = y;
 
+                for (uint8_t x = run->spans[y].x0 & ~3; x < xend; x++) {
+                        if (aligned && x % 4 == 0 && x + 4 <= oled->width &&
+                            rp2040_oled_load32(front + x) == rp2040_oled_load32(back + x)) {
+                                if (width != 0) {
+                                        rp2040_oled_add_run(oled, run, xstart, width);
+                                        width = 0;
+                                }
+                                x += 3;
+                        } else if (front[x] != back[x]) {
+                                if (width == 0)
+                                        xstart = x;
+                                width++;
+                        } else if (width != 0) {
+                                rp2040_oled_add_run(oled, run, xstart, width);
+                                width = 0;
                         }
-                } else {
-                        for (uint8_t xpage = 0; xpage < oled->width / 8; xpage++) {
-                                uint8_t page = oled->dirty_buf[y * (oled->width / 8) + xpage];
-                                if (page) {
-                                        for (uint8_t dx = 0; dx < 8; dx++) {
-                                                if (page & 1 << dx) {
-                                                        if (width == 0) {
-                                                                xstart = xpage * 8 + dx;
-                                                        }
-                                                        width++;
-                                                } else {
-                                                        if (width != 0) {
-                                                                size_t gdram_offset = xstart + (y * oled->width);
-                                                                rp2040_oled_render_gdram(oled, xstart, y, gdram_offset, width);
-
-                                                                width = 0;
-                                                        }
+                }
+
+                if (width != 0)
+                        rp2040_oled_add_run(oled, run, xstart, width);
+                rp2040_oled_end_run(oled, run);
+        }
+}
+
+static void rp2040_oled_scan_dirty(rp2040_oled_t *oled, rp2040_oled_run_t *run)
+{
+        for (uint8_t y = 0; y < oled->height / PAGE_BITS; y++) {
+                uint8_t xstart = 0;
+                uint8_t width = 0;
+
+                if (!(run->pages & 1u << y))
+                        continue;
+
+                run->y = y;
+
+                for (uint8_t xpage = run->spans[y].x0 / 8; xpage <= run->spans[y].x1 / 8;
+                     xpage++) {
+                        uint8_t page = oled->dirty_buf[y * ((oled->width + 7) / 8) + xpage];
+                        if (page) {
+                                for (uint8_t dx = 0; dx < 8; dx++) {
+                                        if (page & 1 << dx) {
+                                                if (width == 0) {
+                                                        xstart = xpage * 8 + dx;
                                                 }
+                                                width++;
+                                        } else if (width != 0) {
+                                                rp2040_oled_add_run(oled, run, xstart, width);
+                                                width = 0;
                                         }
                                 }
+                        } else if (width != 0) {
+                                rp2040_oled_add_run(oled, run, xstart, width);
+                                width = 0;
                         }
                 }
 
-                if (width != 0) {
-                        size_t gdram_offset = xstart + (y * oled->width);
-                        rp2040_oled_render_gdram(oled, xstart, y, gdram_offset, width);
+                if (width != 0)
+                        rp2040_oled_add_run(oled, run, xstart, width);
+                rp2040_oled_end_run(oled, run);
+        }
+}
 
-                        width = 0;
+/*
+ * With horizontal addressing all dirty runs can go out as one window covering
+ * their bounding box, which wins whenever the clean bytes inside the box cost
+ * less than addressing each run.
+ */
+static void rp2040_oled_flush_runs(rp2040_oled_t *oled, const uint8_t *src, uint16_t pages,
+                                   const rp2040_oled_span_t *spans,
+                                   void (*scan)(rp2040_oled_t *oled, rp2040_oled_run_t *run))
+{
+        rp2040_oled_run_t run = { .src = src, .pages = pages, .spans = spans,
+                                  .gap = rp2040_oled_merge_gap(oled) };
+
+        if (oled->use_horizontal_addr) {
+                size_t rect_cost;
+
+                run.dry = true;
+                scan(oled, &run);
+                if (run.cost == 0)
+                        return;
+
+                rect_cost = rp2040_oled_merge_gap(oled) +
+                            (run.x1 - run.x0 + 1) * (run.y1 - run.y0 + 1);
+                if (rect_cost <= run.cost) {
+                        rp2040_oled_render_rect(oled, src, run.x0, run.y0, run.x1 - run.x0 + 1,
+                                                run.y1 - run.y0 + 1);
+                        return;
                 }
+
+                run.dry = false;
         }
 
-        oled->is_dirty = false;
+        scan(oled, &run);
+}
+
+void rp2040_oled_flush_diff(rp2040_oled_t *oled, const uint8_t *back, uint16_t pages,
+                            const rp2040_oled_span_t *spans)
+{
+        rp2040_oled_flush_runs(oled, back, pages, spans, rp2040_oled_scan_diff);
+}
+
+bool rp2040_oled_flush(rp2040_oled_t *oled)
+{
+        /* held back until rp2040_oled_unlock(), the frame is still being drawn */
+        if (oled->fb_locked)
+                return true;
+
+#ifndef RP2040_OLED_HOST
+        if (oled->use_core1)
+                return rp2040_oled_core1_publish(oled);
+#endif
+
+        if (!oled->is_dirty)
+                return true;
 
-        if (!oled->use_doublebuf) {
-                memset(oled->dirty_buf, 0x00, oled->dirty_buf_size);
+        if (oled->use_doublebuf) {
+                rp2040_oled_flush_diff(oled, oled->dirty_buf, oled->dirty_pages,
+                                       oled->dirty_spans);
+        } else {
+                rp2040_oled_flush_runs(oled, oled->gdram, oled->dirty_pages, oled->dirty_spans,
+                                       rp2040_oled_scan_dirty);
+                rp2040_oled_clear_dirty(oled);
         }
 
+        oled->is_dirty = false;
+        oled->dirty_pages = 0;
+
         oled->cursor.x = 0;
         oled->cursor.y = 0;
 
@@ -156,12 +383,20 @@ bool rp2040_oled_flush(rp2040_oled_t *oled)
 
 bool rp2040_oled_force_flush(rp2040_oled_t *oled)
 {
-        for (uint8_t y = 0; y < oled->height / PAGE_BITS; y++) {
-                size_t gdram_offset = y * oled->width;
-                rp2040_oled_render_gdram(oled, 0, y, gdram_offset, oled->width);
+        const uint8_t *src = oled->use_doublebuf ? oled->dirty_buf : oled->gdram;
+
+        if (oled->use_horizontal_addr) {
+                rp2040_oled_render_rect(oled, src, 0, 0, oled->width, oled->height / PAGE_BITS);
+        } else {
+                for (uint8_t y = 0; y < oled->height / PAGE_BITS; y++)
+                        rp2040_oled_render_rect(oled, src, 0, y, oled->width, 1);
         }
 
+        if (!oled->use_doublebuf)
+                rp2040_oled_clear_dirty(oled);
+
         oled->is_dirty = false;
+        oled->dirty_pages = 0;
 
         oled->cursor.x = 0;
         oled->cursor.y = 0;
@@ -169,6 +404,90 @@ bool rp2040_oled_force_flush(rp2040_oled_t *oled)
         return true;
 }
 
+void rp2040_oled_flush_complete(rp2040_oled_t *oled, bool ok)
+{
+        rp2040_oled_flush_cb_t callback = oled->async.callback;
+
+        oled->async.callback = NULL;
+        if (callback)
+                callback(oled, ok, oled->async.user_data);
+}
+
+bool rp2040_oled_flush_busy(rp2040_oled_t *oled)
+{
+#ifndef RP2040_OLED_HOST
+        if (oled->use_core1)
+                return rp2040_oled_core1_busy(oled);
+#endif
+
+        if (!oled->transport->async_busy)
+                return false;
+
+        return oled->transport->async_busy(oled);
+}
+
+bool rp2040_oled_flush_async(rp2040_oled_t *oled, rp2040_oled_flush_cb_t callback,
+                             void *user_data)
+{
+        bool queued;
+        bool ret;
+
+        if (rp2040_oled_flush_busy(oled))
+                return false;
+
+        oled->async.callback = callback;
+        oled->async.user_data = user_data;
+
+        if (oled->fb_locked) {
+                rp2040_oled_flush_complete(oled, true);
+                return true;
+        }
+
+#ifndef RP2040_OLED_HOST
+        if (oled->use_core1) {
+                if (oled->is_dirty)
+                        return rp2040_oled_core1_publish(oled);
+
+                rp2040_oled_flush_complete(oled, true);
+                return true;
+        }
+#endif
+
+        if (!oled->transport->async_begin || !oled->transport->async_begin(oled)) {
+                ret = rp2040_oled_flush(oled);
+                rp2040_oled_flush_complete(oled, ret);
+                return ret;
+        }
+
+        /* submitting also ends recording when the runs did not fit */
+        queued = rp2040_oled_flush(oled);
+        if (oled->transport->async_submit(oled) && queued)
+                return true;
+
+        /* Too many runs to queue, a full frame always fits */
+        if (oled->transport->async_begin(oled)) {
+                queued = rp2040_oled_force_flush(oled);
+                if (oled->transport->async_submit(oled) && queued)
+                        return true;
+        }
+
+        /* the dirty state is spent on the dropped queue, resend it all in place */
+        ret = rp2040_oled_force_flush(oled);
+        rp2040_oled_flush_complete(oled, ret);
+
+        return ret;
+}
+
+/*
+ * Whether a write is left to dirty tracking and the next flush. Rendered
+ * single-buffer writes go straight to the bus instead, unless the buffer is
+ * locked.
+ */
+static bool rp2040_oled_write_deferred(rp2040_oled_t *oled, bool render)
+{
+        return !render || oled->use_doublebuf || oled->fb_locked;
+}
+
 static bool rp2040_oled_write_gdram(rp2040_oled_t *oled, uint8_t *buf, size_t size,
                                     rp2040_oled_color_t color, bool render)
 {
@@ -188,195 +507,692 @@ static bool rp2040_oled_write_gdram(rp2040_oled_t *oled, uint8_t *buf, size_t si
         }
         memcpy(gdram + gdram_offset, buf, size);
 
-        if (!render) {
-                if (!oled->use_doublebuf)
-                        for (uint8_t x = oled->cursor.x; x < oled->cursor.x + size; x++)
-                                oled->dirty_buf[oled->cursor.y * (oled->width / 8) + x / 8] |= 1 << x % 8;
-
-                oled->is_dirty = true;
-        } else if (oled->use_doublebuf) {
-                oled->is_dirty = true;
-        }
+        if (rp2040_oled_write_deferred(oled, render))
+                rp2040_oled_touch(oled, oled->cursor.y, oled->cursor.x, size);
 
         oled->cursor.x += size;
 
         if (!render)
                 return true;
 
-        return oled->use_doublebuf ? rp2040_oled_flush(oled) : rp2040_i2c_write(oled, buf - 1, size + 1) == size + 1;
+        if (rp2040_oled_write_deferred(oled, render))
+                return rp2040_oled_flush(oled);
+
+        return rp2040_oled_bus_write_data(oled, gdram + gdram_offset, size, 1, size) == size;
 }
 
-static bool rp2040_oled_fill(rp2040_oled_t *oled, uint8_t fill_byte, bool render)
+/*
+ * Raster op color applied to the bits of dst selected by mask, with the source
+ * bits in src. Works the same on a byte and on four page bytes in a word.
+ */
+static inline uint32_t rp2040_oled_rop(uint32_t dst, uint32_t src, uint32_t mask,
+                                       rp2040_oled_color_t color)
 {
-        uint8_t *fill_buf;
-        size_t fill_buf_size = oled->width;
-
-        fill_buf = rp2040_oled_alloc_data_buf(fill_buf_size);
-        memset(fill_buf, fill_byte, fill_buf_size);
-
-        for (uint8_t y = 0; y < oled->height; y += PAGE_BITS) {
-                if (!rp2040_oled_set_position(oled, 0, y, false)) {
-                        rp2040_oled_free_data_buf(fill_buf);
-                        return false;
-                }
-
-                if (!rp2040_oled_write_gdram(oled, fill_buf, fill_buf_size, OLED_COLOR_FULL_BYTE, false)) {
-                        rp2040_oled_free_data_buf(fill_buf);
-                        return false;
-                }
+        switch (color) {
+                case OLED_COLOR_WHITE:
+                        return dst | (src & mask);
+                case OLED_COLOR_BLACK:
+                        return dst & (src | ~mask);
+                case OLED_COLOR_FULL_BYTE:
+                        return (dst & ~mask) | (src & mask);
+                case OLED_COLOR_XOR:
+                        return dst ^ (src & mask);
+                case OLED_COLOR_AND_NOT:
+                        return dst & ~(src & mask);
+                case OLED_COLOR_INVERT:
+                        return dst ^ mask;
         }
 
-        if (render)
-                rp2040_oled_flush(oled);
-
-        rp2040_oled_free_data_buf(fill_buf);
-        return true;
+        return dst;
 }
 
-bool rp2040_oled_write_string(rp2040_oled_t *oled, uint8_t x, uint8_t y, char *msg,
-                              size_t len, bool render)
+/*
+ * Applies color to count page bytes of a row, limited to the rows in rows and,
+ * with a mask, to its set bits. Goes a word at a time once dst is aligned if
+ * src and mask line up with it.
+ */
+static void rp2040_oled_rop_row(uint8_t *dst, const uint8_t *src, const uint8_t *mask,
+                                uint8_t count, uint8_t rows, rp2040_oled_color_t color)
 {
-        uint8_t *buf;
-        size_t buf_size = len * 6;
-        size_t i = 0;
-        if (x >= oled->width || y >= oled->height)
-                return false;
+        uint8_t i = 0;
 
-        if (!rp2040_oled_set_position(oled, x, y, render))
-                return false;
+        if (!(((uintptr_t)dst ^ (uintptr_t)src) & 3) &&
+            (!mask || !(((uintptr_t)dst ^ (uintptr_t)mask) & 3))) {
+                uint32_t rows_word = rows * 0x01010101u;
 
-        buf = rp2040_oled_alloc_data_buf(buf_size);
+                for (; i < count && ((uintptr_t)(dst + i) & 3); i++)
+                        dst[i] = rp2040_oled_rop(dst[i], src[i], mask ? mask[i] & rows : rows,
+                                                 color);
 
-        for (i = 0; i < len; i++) {
-                uint8_t font_index = msg[i] - 32;
+                for (; i + 4 <= count; i += 4) {
+                        uint32_t bits = rp2040_oled_load32(src + i);
+                        uint32_t m = mask ? rp2040_oled_load32(mask + i) & rows_word : rows_word;
 
-                buf[i * 6] = 0x00;
-                memcpy(buf + (1 + (i * 6)), font_6x8 + (font_index * 5), 5);
+                        rp2040_oled_store32(dst + i, rp2040_oled_rop(rp2040_oled_load32(dst + i),
+                                                                     bits, m, color));
+                }
         }
 
-        if (!rp2040_oled_write_gdram(oled, buf, buf_size, OLED_COLOR_WHITE, render)) {
-                rp2040_oled_free_data_buf(buf);
-                return false;
-        }
+        for (; i < count; i++)
+                dst[i] = rp2040_oled_rop(dst[i], src[i], mask ? mask[i] & rows : rows, color);
+}
 
-        rp2040_oled_free_data_buf(buf);
-        return true;
+/* Same as rp2040_oled_fill_span(), for coordinates that may be off screen */
+static void rp2040_oled_fill_clipped(rp2040_oled_t *oled, int16_t x0, int16_t x1, int16_t y0,
+                                     int16_t y1, rp2040_oled_color_t color)
+{
+        if (x0 < 0)
+                x0 = 0;
+        if (y0 < 0)
+                y0 = 0;
+        if (x1 >= oled->width)
+                x1 = oled->width - 1;
+        if (y1 >= oled->height)
+                y1 = oled->height - 1;
+
+        if (x0 > x1 || y0 > y1)
+                return;
+
+        rp2040_oled_fill_span(oled, x0, x1, y0, y1, color);
 }
 
-bool rp2040_oled_set_pixel(rp2040_oled_t *oled, uint8_t x, uint8_t y,
-                           rp2040_oled_color_t color, bool render)
+/*
+ * Pixels plotted through a batch go straight into the working buffer, only
+ * the bitmap bit is set per pixel. The column span of every page touched is
+ * collected and handed to dirty tracking once in rp2040_oled_batch_commit().
+ */
+typedef struct {
+        uint8_t            *fb;
+        uint16_t           pages;
+        rp2040_oled_span_t spans[OLED_MAX_PAGES];
+} rp2040_oled_batch_t;
+
+static void rp2040_oled_batch_init(rp2040_oled_t *oled, rp2040_oled_batch_t *batch)
+{
+        batch->fb = oled->use_doublebuf ? oled->dirty_buf : oled->gdram;
+        batch->pages = 0;
+}
+
+static void rp2040_oled_plot(rp2040_oled_t *oled, rp2040_oled_batch_t *batch, int16_t x,
+                             int16_t y, rp2040_oled_color_t color)
 {
-        bool ret = true;
         uint8_t page = y / PAGE_BITS;
-        uint8_t page_offset = y % PAGE_BITS;
-        uint8_t bit_mask = 1 << page_offset;
-        uint8_t buf[2] = {OLED_CB_DATA_BIT, 0x00};
-        uint8_t *gdram = oled->use_doublebuf ? oled->dirty_buf : oled->gdram;
+        rp2040_oled_span_t *span;
 
-        if (x >= oled->width || y >= oled->height)
-                return false;
+        if (x < 0 || y < 0 || x >= oled->width || y >= oled->height)
+                return;
+
+        span = &batch->spans[page];
 
-        buf[1] = gdram[x + (page * oled->width)];
         if (color == OLED_COLOR_WHITE)
-                buf[1] |= bit_mask;
-        else if (color == OLED_COLOR_BLACK)
-                buf[1] &= ~bit_mask;
+                batch->fb[page * oled->width + x] |= 1 << y % PAGE_BITS;
+        else if (color == OLED_COLOR_XOR || color == OLED_COLOR_INVERT)
+                batch->fb[page * oled->width + x] ^= 1 << y % PAGE_BITS;
         else
-                return false;
+                batch->fb[page * oled->width + x] &= ~(1 << y % PAGE_BITS);
+
+        if (!oled->use_doublebuf)
+                oled->dirty_buf[page * ((oled->width + 7) / 8) + x / 8] |= 1 << x % 8;
+
+        if (!(batch->pages & 1u << page)) {
+                batch->pages |= 1u << page;
+                span->x0 = x;
+                span->x1 = x;
+        } else if (x < span->x0) {
+                span->x0 = x;
+        } else if (x > span->x1) {
+                span->x1 = x;
+        }
+}
 
-        if (!rp2040_oled_set_position(oled, x, page * PAGE_BITS, render))
-                return false;
+static void rp2040_oled_batch_commit(rp2040_oled_t *oled, rp2040_oled_batch_t *batch)
+{
+        if (!batch->pages)
+                return;
 
-        if (!rp2040_oled_write_gdram(oled, buf + 1, 1, color, render))
-                ret = false;
+        for (uint8_t page = 0; page < oled->height / PAGE_BITS; page++) {
+                if (batch->pages & 1u << page)
+                        rp2040_oled_mark_dirty(oled, page, batch->spans[page].x0,
+                                               batch->spans[page].x1 - batch->spans[page].x0 + 1);
+        }
 
-        return ret;
+        oled->is_dirty = true;
 }
 
-bool rp2040_oled_draw_line(rp2040_oled_t *oled, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1,
-                           rp2040_oled_color_t color, bool render)
+static bool rp2040_oled_fill(rp2040_oled_t *oled, rp2040_oled_color_t color, bool render)
 {
-        int16_t dx = abs(x1 - x0);
-        int16_t dy = -abs(y1 - y0);
-        int8_t sx = x0 < x1 ? 1 : -1;
-        int8_t sy = y0 < y1 ? 1 : -1;
-        int16_t err = dx + dy;
-        int16_t err2;
-        uint8_t bit_mask = (color == OLED_COLOR_WHITE) ? 0x00 : 0xff;
-        uint8_t buf[2] = {OLED_CB_DATA_BIT, 0x00};
+        rp2040_oled_fill_span(oled, 0, oled->width - 1, 0, oled->height - 1, color);
 
-        if (x0 >= oled->width || x1 >= oled->width || y0 >= oled->height || y1 >= oled->height)
-                return false;
+        if (render)
+                return rp2040_oled_flush(oled);
 
-        if (x0 == x1) {
-                if (y0 / PAGE_BITS == y1 / PAGE_BITS) {
-                        for (uint8_t y = y0; y != y1; y += sy) {
-                                uint8_t bitshift = 1 << (sy == 1 ? y % PAGE_BITS : PAGE_BITS - y % PAGE_BITS);
-                                if (color == OLED_COLOR_WHITE)
-                                        bit_mask |= bitshift;
-                                else
-                                        bit_mask &= ~bitshift;
-                        }
-                        rp2040_oled_set_position(oled, x0, y0, render);
-                        buf[1] = bit_mask;
-                        rp2040_oled_write_gdram(oled, buf + 1, 1, color, render);
-                } else {
-                        uint8_t tshift, bshift, y;
-                        if (y0 > y1) {
-                                y = y1;
-                                y1 = y0;
-                                y0 = y;
-                        }
+        return true;
+}
 
-                        tshift = PAGE_BITS - y0 % PAGE_BITS;
-                        bshift = y1 % PAGE_BITS;
-                        y = y0;
-
-                        if (tshift) {
-                                bit_mask = (color == OLED_COLOR_WHITE) ? 0x00 : 0xff;
-                                for (uint8_t i = 0; i < tshift; i++) {
-                                        uint8_t bitshift = 1 << ((PAGE_BITS - 1) - i);
-                                        if (color == OLED_COLOR_WHITE)
-                                                bit_mask |= bitshift;
-                                        else
-                                                bit_mask &= ~bitshift;
-                                }
-                                rp2040_oled_set_position(oled, x0, y, false);
-                                buf[1] = bit_mask;
-                                rp2040_oled_write_gdram(oled, buf + 1, 1, color, false);
-                                y += tshift;
-                        }
+/*
+ * The 5 columns of a glyph shifted down by shift rows: the low byte lands in
+ * the glyph's first page, the high byte in the page below. Comes from the
+ * glyph cache if there is one, otherwise it is shifted into buf.
+ */
+static const uint16_t *rp2040_oled_glyph(rp2040_oled_t *oled, char c, uint8_t shift,
+                                         uint16_t *buf)
+{
+        rp2040_oled_glyph_cache_t *cache = oled->glyph_cache;
+        uint8_t index = (uint8_t)c >= 32 && (uint8_t)c < 128 ? c - 32 : 0;
+        const uint8_t *glyph = font_6x8 + index * 5;
+        uint8_t slot = index % RP2040_OLED_GLYPH_CACHE_SLOTS;
+
+        if (cache && shift) {
+                if (cache->shift != shift) {
+                        memset(cache->glyphs, 0x00, sizeof(cache->glyphs));
+                        cache->shift = shift;
+                }
 
-                        buf[1] = (color == OLED_COLOR_WHITE) ? 0xff : 0x00;
-                        while (y / PAGE_BITS < y1 / PAGE_BITS) {
-                                rp2040_oled_set_position(oled, x0, y, false);
-                                rp2040_oled_write_gdram(oled, buf + 1, 1, color, false);
-                                y += PAGE_BITS;
-                        }
+                buf = cache->columns[slot];
+                if (cache->glyphs[slot] == index + 1)
+                        return buf;
+                cache->glyphs[slot] = index + 1;
+        }
 
-                        if (bshift) {
-                                bit_mask = (color == OLED_COLOR_WHITE) ? 0x00 : 0xff;
-                                for (uint8_t i = 0; i < bshift; i++) {
-                                        uint8_t bitshift = 1 << i;
-                                        if (color == OLED_COLOR_WHITE)
-                                                bit_mask |= bitshift;
-                                        else
-                                                bit_mask &= ~bitshift;
-                                }
-                                rp2040_oled_set_position(oled, x0, y, false);
-                                buf[1] = bit_mask;
-                                rp2040_oled_write_gdram(oled, buf + 1, 1, color, false);
-                                y += bshift;
-                        }
+        for (uint8_t i = 0; i < 5; i++)
+                buf[i] = glyph[i] << shift;
 
-                        if (render)
-                                rp2040_oled_flush(oled);
-                }
+        return buf;
+}
+
+bool rp2040_oled_write_string(rp2040_oled_t *oled, uint8_t x, uint8_t y, char *msg,
+                              size_t len, bool render)
+{
+        uint8_t *gdram = oled->use_doublebuf ? oled->dirty_buf : oled->gdram;
+        uint8_t page = y / PAGE_BITS;
+        uint8_t shift = y % PAGE_BITS;
+        uint8_t pages = shift && page + 1 < oled->height / PAGE_BITS ? 2 : 1;
+        uint8_t *dst = gdram + page * oled->width;
+        uint16_t buf[5];
+        size_t width;
+
+        if (x >= oled->width || y >= oled->height)
+                return false;
+
+        if (len == 0)
+                return true;
+
+        /* 6 columns per character, the first one is blank */
+        width = len * 6;
+        if (width > (size_t)(oled->width - x))
+                width = oled->width - x;
+
+        for (size_t col = 1; col < width; col += 6) {
+                const uint16_t *glyph = rp2040_oled_glyph(oled, msg[col / 6], shift, buf);
+
+                for (uint8_t i = 0; i < 5 && col + i < width; i++) {
+                        dst[x + col + i] |= glyph[i];
+                        if (pages > 1)
+                                dst[oled->width + x + col + i] |= glyph[i] >> 8;
+                }
+        }
+
+        if (rp2040_oled_write_deferred(oled, render)) {
+                for (uint8_t i = 0; i < pages; i++)
+                        rp2040_oled_touch(oled, page + i, x, width);
+        }
+
+        if (!render)
+                return true;
+
+        if (rp2040_oled_write_deferred(oled, render))
+                return rp2040_oled_flush(oled);
+
+        for (uint8_t i = 0; i < pages; i++) {
+                if (!rp2040_oled_render_rect(oled, oled->gdram, x, page + i, width, 1))
+                        return false;
+        }
+
+        return true;
+}
+
+typedef struct {
+        const uint8_t *src;
+        bool          rle;
+        bool          repeat;
+        uint8_t       left;
+} rp2040_oled_glyph_reader_t;
+
+static uint8_t rp2040_oled_glyph_read(rp2040_oled_glyph_reader_t *reader)
+{
+        if (!reader->rle)
+                return *reader->src++;
+
+        if (reader->left == 0) {
+                reader->repeat = *reader->src & 0x80;
+                reader->left = (*reader->src++ & 0x7f) + 1;
+        }
+
+        reader->left--;
+        if (reader->repeat && reader->left)
+                return *reader->src;
+
+        return *reader->src++;
+}
+
+/*
+ * Applies color to the 8 rows of bits starting at row, which may be up to 7
+ * rows above the screen
+ */
+static void rp2040_oled_blend_column(rp2040_oled_t *oled, uint8_t *fb, uint8_t x, int16_t row,
+                                     uint8_t bits, rp2040_oled_color_t color)
+{
+        int16_t page = row >= 0 ? row / PAGE_BITS : -1;
+        uint16_t column = bits << (row - page * PAGE_BITS);
+
+        for (; column && page < oled->height / PAGE_BITS; page++, column >>= PAGE_BITS) {
+                uint8_t *dst;
+
+                if (page < 0 || !(column & 0xff))
+                        continue;
+
+                dst = fb + page * oled->width + x;
+                *dst = rp2040_oled_rop(*dst, column, 0xff, color);
+        }
+}
+
+/* Inclusive screen area text is drawn into */
+typedef struct {
+        int16_t x0, y0;
+        int16_t x1, y1;
+} rp2040_oled_clip_t;
+
+static void rp2040_oled_draw_glyph(rp2040_oled_t *oled, uint8_t *fb,
+                                   const rp2040_oled_font_t *font,
+                                   const rp2040_oled_glyph_t *glyph, int16_t x, int16_t y,
+                                   const rp2040_oled_clip_t *clip, rp2040_oled_color_t color)
+{
+        rp2040_oled_glyph_reader_t reader = { .src = font->data + glyph->offset,
+                                              .rle = font->rle };
+        int16_t top = y + glyph->y_offset;
+
+        for (uint8_t page = 0; page < (glyph->height + 7) / PAGE_BITS; page++) {
+                int16_t row = top + page * PAGE_BITS;
+                uint8_t mask = 0xff;
+
+                if (row + PAGE_BITS - 1 < clip->y0 || row > clip->y1)
+                        mask = 0x00;
+                if (mask && row < clip->y0)
+                        mask <<= clip->y0 - row;
+                if (mask && row + PAGE_BITS - 1 > clip->y1)
+                        mask >>= row + PAGE_BITS - 1 - clip->y1;
+
+                for (int16_t col = x; col < x + glyph->width; col++) {
+                        uint8_t bits = rp2040_oled_glyph_read(&reader) & mask;
+
+                        /* rle data has to be read through even where it is clipped */
+                        if (bits && col >= clip->x0 && col <= clip->x1)
+                                rp2040_oled_blend_column(oled, fb, col, row, bits, color);
+                }
+        }
+}
+
+/*
+ * Decodes the code point at *pos and moves past it. Malformed sequences
+ * (stray continuation bytes, overlong forms, surrogates, truncation) come
+ * out as U+FFFD one byte at a time.
+ */
+static uint32_t rp2040_oled_utf8_next(const char *msg, size_t len, size_t *pos)
+{
+        const uint8_t *s = (const uint8_t *)msg + *pos;
+        size_t left = len - *pos;
+        uint32_t cp;
+        uint8_t n;
+
+        (*pos)++;
+
+        if (s[0] < 0x80)
+                return s[0];
+
+        if (s[0] >= 0xc2 && s[0] < 0xe0) {
+                n = 1;
+                cp = s[0] & 0x1f;
+        } else if (s[0] >= 0xe0 && s[0] < 0xf0) {
+                n = 2;
+                cp = s[0] & 0x0f;
+        } else if (s[0] >= 0xf0 && s[0] < 0xf5) {
+                n = 3;
+                cp = s[0] & 0x07;
+        } else {
+                return 0xfffd;
+        }
+
+        if (left <= n)
+                return 0xfffd;
+
+        for (uint8_t i = 1; i <= n; i++) {
+                if ((s[i] & 0xc0) != 0x80)
+                        return 0xfffd;
+                cp = cp << 6 | (s[i] & 0x3f);
+        }
+
+        if ((n == 2 && (cp < 0x800 || (cp >= 0xd800 && cp < 0xe000))) ||
+            (n == 3 && (cp < 0x10000 || cp > 0x10ffff)))
+                return 0xfffd;
+
+        *pos += n;
+        return cp;
+}
+
+static const rp2040_oled_glyph_t *rp2040_oled_font_lookup(const rp2040_oled_font_t *font,
+                                                          uint32_t cp)
+{
+        uint16_t lo = 0, hi = font->range_count;
+
+        while (lo < hi) {
+                uint16_t mid = lo + (hi - lo) / 2;
+                const rp2040_oled_font_range_t *range = &font->ranges[mid];
+
+                if (cp < range->first)
+                        hi = mid;
+                else if (cp - range->first >= range->count)
+                        lo = mid + 1;
+                else
+                        return &font->glyphs[range->glyph + cp - range->first];
+        }
+
+        return NULL;
+}
+
+static const rp2040_oled_glyph_t *rp2040_oled_font_glyph(const rp2040_oled_font_t *font,
+                                                         uint32_t cp)
+{
+        const rp2040_oled_glyph_t *glyph = rp2040_oled_font_lookup(font, cp);
+
+        if (!glyph && font->fallback)
+                glyph = rp2040_oled_font_lookup(font, font->fallback);
+
+        return glyph;
+}
+
+/* Raster op for drawing glyphs in color, black clears the glyph's pixels */
+static bool rp2040_oled_text_color(rp2040_oled_color_t *color)
+{
+        if (*color == OLED_COLOR_BLACK)
+                *color = OLED_COLOR_AND_NOT;
+
+        return *color == OLED_COLOR_WHITE || *color == OLED_COLOR_AND_NOT ||
+               *color == OLED_COLOR_XOR;
+}
+
+static void rp2040_oled_text_line(rp2040_oled_t *oled, const rp2040_oled_font_t *font,
+                                  int16_t x, int16_t y, const char *msg, size_t len,
+                                  const rp2040_oled_clip_t *clip, rp2040_oled_color_t color)
+{
+        uint8_t *fb = oled->use_doublebuf ? oled->dirty_buf : oled->gdram;
+        /* bounding box of the glyphs drawn */
+        int16_t x0 = clip->x1 + 1, x1 = clip->x0 - 1, y0 = clip->y1 + 1, y1 = clip->y0 - 1;
+
+        for (size_t pos = 0; pos < len && x <= clip->x1;) {
+                const rp2040_oled_glyph_t *glyph;
+                int16_t top;
+
+                glyph = rp2040_oled_font_glyph(font, rp2040_oled_utf8_next(msg, len, &pos));
+                if (!glyph)
+                        continue;
+
+                top = y + glyph->y_offset;
+                if (x + glyph->width > clip->x0 && glyph->height && top <= clip->y1 &&
+                    top + glyph->height > clip->y0) {
+                        rp2040_oled_draw_glyph(oled, fb, font, glyph, x, y, clip, color);
+
+                        if (x < x0)
+                                x0 = x;
+                        if (x + glyph->width - 1 > x1)
+                                x1 = x + glyph->width - 1;
+                        if (top < y0)
+                                y0 = top;
+                        if (top + glyph->height - 1 > y1)
+                                y1 = top + glyph->height - 1;
+                }
+
+                x += glyph->advance;
+        }
+
+        if (x0 < clip->x0)
+                x0 = clip->x0;
+        if (x1 > clip->x1)
+                x1 = clip->x1;
+        if (y0 < clip->y0)
+                y0 = clip->y0;
+        if (y1 > clip->y1)
+                y1 = clip->y1;
+
+        for (int16_t page = y0 / PAGE_BITS; x0 <= x1 && page <= y1 / PAGE_BITS; page++)
+                rp2040_oled_touch(oled, page, x0, x1 - x0 + 1);
+}
+
+bool rp2040_oled_draw_text(rp2040_oled_t *oled, const rp2040_oled_font_t *font, int16_t x,
+                           int16_t y, const char *msg, size_t len, rp2040_oled_color_t color,
+                           bool render)
+{
+        rp2040_oled_clip_t clip = { 0, 0, oled->width - 1, oled->height - 1 };
+
+        if (!rp2040_oled_text_color(&color))
+                return false;
+
+        rp2040_oled_text_line(oled, font, x, y, msg, len, &clip, color);
+
+        if (render)
+                return rp2040_oled_flush(oled);
+
+        return true;
+}
+
+uint16_t rp2040_oled_text_width(const rp2040_oled_font_t *font, const char *msg, size_t len)
+{
+        uint16_t width = 0, pen = 0;
+
+        for (size_t pos = 0; pos < len;) {
+                const rp2040_oled_glyph_t *glyph;
+
+                glyph = rp2040_oled_font_glyph(font, rp2040_oled_utf8_next(msg, len, &pos));
+                if (!glyph)
+                        continue;
+
+                if (pen + glyph->width > width)
+                        width = pen + glyph->width;
+                pen += glyph->advance;
+        }
+
+        return width;
+}
+
+bool rp2040_oled_layout_text(rp2040_oled_layout_t *layout, const rp2040_oled_font_t *font,
+                             const rp2040_oled_rect_t *rect, const char *msg, size_t len,
+                             rp2040_oled_align_t align)
+{
+        size_t pos = 0;
+
+        layout->font = font;
+        layout->msg = msg;
+        layout->rect = *rect;
+        layout->line_count = 0;
+
+        while (pos < len) {
+                size_t start = pos, end = pos, next = len;
+                uint16_t width;
+
+                /* greedy: take words while they fit, break inside a word only if it is alone */
+                while (end < len && msg[end] != '\n') {
+                        size_t word = end, stop = end;
+
+                        while (stop < len && msg[stop] == ' ')
+                                stop++;
+                        while (stop < len && msg[stop] != ' ' && msg[stop] != '\n')
+                                stop++;
+
+                        if (rp2040_oled_text_width(font, msg + start, stop - start) <= rect->width) {
+                                end = stop;
+                                continue;
+                        }
+
+                        if (word == start) {
+                                /* a single word wider than the box, cut it per code point */
+                                for (end = start; end < stop;) {
+                                        size_t cut = end;
+
+                                        rp2040_oled_utf8_next(msg, len, &cut);
+                                        if (end > start &&
+                                            rp2040_oled_text_width(font, msg + start,
+                                                                   cut - start) > rect->width)
+                                                break;
+                                        end = cut;
+                                }
+                        }
+                        break;
+                }
+
+                next = end;
+                if (next < len && msg[next] == '\n')
+                        next++;
+                else
+                        while (next < len && msg[next] == ' ')
+                                next++;
+
+                /* leading spaces of a line are kept, trailing ones are not */
+                while (end > start && msg[end - 1] == ' ')
+                        end--;
+
+                /* the last line may be cut off at the bottom */
+                if (layout->line_count == RP2040_OLED_LAYOUT_LINES ||
+                    layout->line_count * font->height >= rect->height)
+                        return false;
+
+                width = rp2040_oled_text_width(font, msg + start, end - start);
+                layout->lines[layout->line_count].start = start;
+                layout->lines[layout->line_count].len = end - start;
+                layout->lines[layout->line_count].x = rect->x;
+                if (align == OLED_ALIGN_CENTER)
+                        layout->lines[layout->line_count].x += (rect->width - width) / 2;
+                else if (align == OLED_ALIGN_RIGHT)
+                        layout->lines[layout->line_count].x += rect->width - width;
+                layout->line_count++;
+
+                pos = next;
+        }
+
+        return true;
+}
+
+bool rp2040_oled_draw_layout(rp2040_oled_t *oled, const rp2040_oled_layout_t *layout,
+                             rp2040_oled_color_t color, bool render)
+{
+        const rp2040_oled_rect_t *rect = &layout->rect;
+        rp2040_oled_clip_t clip = { rect->x, rect->y, rect->x + rect->width - 1,
+                                    rect->y + rect->height - 1 };
+
+        if (!rp2040_oled_text_color(&color))
+                return false;
+
+        if (clip.x1 >= oled->width)
+                clip.x1 = oled->width - 1;
+        if (clip.y1 >= oled->height)
+                clip.y1 = oled->height - 1;
+        if (clip.x0 > clip.x1 || clip.y0 > clip.y1)
+                return true;
+
+        for (uint8_t i = 0; i < layout->line_count; i++)
+                rp2040_oled_text_line(oled, layout->font, layout->lines[i].x,
+                                      rect->y + i * layout->font->height,
+                                      layout->msg + layout->lines[i].start,
+                                      layout->lines[i].len, &clip, color);
+
+        if (render)
+                return rp2040_oled_flush(oled);
+
+        return true;
+}
+
+bool rp2040_oled_set_pixel(rp2040_oled_t *oled, uint8_t x, uint8_t y,
+                           rp2040_oled_color_t color, bool render)
+{
+        bool ret = true;
+        uint8_t page = y / PAGE_BITS;
+        uint8_t page_offset = y % PAGE_BITS;
+        uint8_t bit_mask = 1 << page_offset;
+        uint8_t buf[2] = {OLED_CB_DATA_BIT, 0x00};
+        uint8_t *gdram = oled->use_doublebuf ? oled->dirty_buf : oled->gdram;
+
+        if (x >= oled->width || y >= oled->height)
+                return false;
+
+        if (!render)
+                return rp2040_oled_set_pixels(oled, &(rp2040_oled_point_t){ x, y }, 1, color,
+                                              false);
+
+        buf[1] = gdram[x + (page * oled->width)];
+        if (color == OLED_COLOR_WHITE)
+                buf[1] |= bit_mask;
+        else if (color == OLED_COLOR_BLACK)
+                buf[1] &= ~bit_mask;
+        else
+                return false;
+
+        if (!rp2040_oled_set_position(oled, x, page * PAGE_BITS, render))
+                return false;
+
+        if (!rp2040_oled_write_gdram(oled, buf + 1, 1, color, render))
+                ret = false;
+
+        return ret;
+}
+
+bool rp2040_oled_set_pixels(rp2040_oled_t *oled, const rp2040_oled_point_t *points,
+                            size_t count, rp2040_oled_color_t color, bool render)
+{
+        rp2040_oled_batch_t batch;
+
+        if (color != OLED_COLOR_WHITE && color != OLED_COLOR_BLACK)
+                return false;
+
+        rp2040_oled_batch_init(oled, &batch);
+        for (size_t i = 0; i < count; i++)
+                rp2040_oled_plot(oled, &batch, points[i].x, points[i].y, color);
+        rp2040_oled_batch_commit(oled, &batch);
+
+        if (render)
+                return rp2040_oled_flush(oled);
+
+        return true;
+}
+
+bool rp2040_oled_draw_line(rp2040_oled_t *oled, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1,
+                           rp2040_oled_color_t color, bool render)
+{
+        int16_t dx = abs(x1 - x0);
+        int16_t dy = -abs(y1 - y0);
+        int8_t sx = x0 < x1 ? 1 : -1;
+        int8_t sy = y0 < y1 ? 1 : -1;
+        int16_t err = dx + dy;
+        int16_t err2;
+        rp2040_oled_batch_t batch;
+
+        if (x0 >= oled->width || x1 >= oled->width || y0 >= oled->height || y1 >= oled->height)
+                return false;
+
+        if (!rp2040_oled_shape_color(color))
+                return false;
+
+        /* straight lines are one column or one row wide rectangles */
+        if (x0 == x1 || y0 == y1) {
+                rp2040_oled_fill_span(oled, x0 < x1 ? x0 : x1, x0 < x1 ? x1 : x0,
+                                      y0 < y1 ? y0 : y1, y0 < y1 ? y1 : y0, color);
+
+                if (render)
+                        rp2040_oled_flush(oled);
                 return true;
         }
 
+        rp2040_oled_batch_init(oled, &batch);
+
         while(1) {
-                rp2040_oled_set_pixel(oled, x0, y0, color, false);
+                rp2040_oled_plot(oled, &batch, x0, y0, color);
                 if (x0 == x1 && y0 == y1)
                         break;
 
@@ -396,6 +1212,8 @@ bool rp2040_oled_draw_line(rp2040_oled_t *oled, uint8_t x0, uint8_t y0, uint8_t
                 }
         }
 
+        rp2040_oled_batch_commit(oled, &batch);
+
         if (render)
                 rp2040_oled_flush(oled);
         return true;
@@ -406,6 +1224,9 @@ bool rp2040_oled_draw_rectangle(rp2040_oled_t *oled, uint8_t x0, uint8_t y0, uin
 {
         uint8_t tmp = 0;
 
+        if (!rp2040_oled_shape_color(color))
+                return false;
+
         if (x0 > x1) {
                 tmp = x0;
                 x0 = x1;
@@ -419,14 +1240,17 @@ bool rp2040_oled_draw_rectangle(rp2040_oled_t *oled, uint8_t x0, uint8_t y0, uin
         }
 
         if (!fill) {
-                rp2040_oled_draw_line(oled, x0, y0, x0, y1, color, false);
-                rp2040_oled_draw_line(oled, x0, y0, x1, y0, color, false);
-                rp2040_oled_draw_line(oled, x1, y0, x1, y1, color, false);
-                rp2040_oled_draw_line(oled, x0, y1, x1, y1, color, false);
-        } else {
-                for (uint8_t x = x0; x <= x1; x++) {
-                        rp2040_oled_draw_line(oled, x, y0, x, y1, color, false);
+                /* edges do not overlap, so xor outlines come out whole */
+                rp2040_oled_fill_clipped(oled, x0, x1, y0, y0, color);
+                if (y1 != y0)
+                        rp2040_oled_fill_clipped(oled, x0, x1, y1, y1, color);
+                if (y1 - y0 > 1) {
+                        rp2040_oled_fill_clipped(oled, x0, x0, y0 + 1, y1 - 1, color);
+                        if (x1 != x0)
+                                rp2040_oled_fill_clipped(oled, x1, x1, y0 + 1, y1 - 1, color);
                 }
+        } else {
+                rp2040_oled_fill_clipped(oled, x0, x1, y0, y1, color);
         }
 
         if (render)
@@ -435,182 +1259,572 @@ bool rp2040_oled_draw_rectangle(rp2040_oled_t *oled, uint8_t x0, uint8_t y0, uin
         return true;
 }
 
+bool rp2040_oled_lock_framebuffer(rp2040_oled_t *oled, rp2040_oled_framebuffer_t *fb)
+{
+        if (oled->fb_locked)
+                return false;
+
+        fb->data = oled->use_doublebuf ? oled->dirty_buf : oled->gdram;
+        fb->stride = oled->width;
+        fb->width = oled->width;
+        fb->height = oled->height;
+        fb->format = OLED_FB_PAGED_1BPP;
+
+        oled->fb_locked = true;
+
+        return true;
+}
+
+bool rp2040_oled_unlock(rp2040_oled_t *oled, const rp2040_oled_rect_t *rect)
+{
+        rp2040_oled_rect_t all = { 0, 0, oled->width, oled->height };
+        uint8_t width, y1;
+
+        if (!oled->fb_locked)
+                return false;
+
+        oled->fb_locked = false;
+
+        if (!rect)
+                rect = &all;
+
+        if (rect->x >= oled->width || rect->y >= oled->height ||
+            rect->width == 0 || rect->height == 0)
+                return true;
+
+        width = rect->width < oled->width - rect->x ? rect->width : oled->width - rect->x;
+        y1 = rect->height < oled->height - rect->y ? rect->y + rect->height - 1 :
+                                                      oled->height - 1;
+
+        for (uint8_t page = rect->y / PAGE_BITS; page <= y1 / PAGE_BITS; page++)
+                rp2040_oled_touch(oled, page, rect->x, width);
+
+        return true;
+}
+
 bool rp2040_oled_clear(rp2040_oled_t *oled)
 {
-        return rp2040_oled_fill(oled, 0x00, true);
+        return rp2040_oled_fill(oled, OLED_COLOR_BLACK, true);
 }
 
 bool rp2040_oled_clear_gdram(rp2040_oled_t *oled)
 {
-        return rp2040_oled_fill(oled, 0x00, false);
+        return rp2040_oled_fill(oled, OLED_COLOR_BLACK, false);
 }
 
-bool rp2040_oled_draw_sprite(rp2040_oled_t *oled, const uint8_t *sprite, int16_t x,
-                             int16_t y, uint8_t width, uint8_t height,
-                             rp2040_oled_color_t color, bool render)
+/*
+ * Makes the next flush send all of page: with use_doublebuf the mirror is set
+ * to the opposite of the framebuffer, it is not known what the panel shows.
+ */
+static void rp2040_oled_invalidate_page(rp2040_oled_t *oled, uint8_t page)
 {
-        bool ret = true;
-        uint8_t *buf;
-        size_t buf_size;
-        uint8_t orig_width = width;
-        const uint8_t *final_sprite = sprite;
-        uint8_t orig_pages, final_pages;
-        uint8_t *osprite = NULL;
-        size_t osprite_size;
-        uint8_t xshift = 0, yshift = 0;
+        if (oled->use_doublebuf) {
+                for (uint8_t x = 0; x < oled->width; x++)
+                        oled->gdram[page * oled->width + x] =
+                                ~oled->dirty_buf[page * oled->width + x];
+        }
 
-        if (x + width < 0 || y + height < 0)
+        rp2040_oled_touch(oled, page, 0, oled->width);
+}
+
+/* Moves count pages of stride bytes up (or down) by shift pages */
+static void rp2040_oled_move_pages(void *buf, size_t stride, uint8_t count, uint8_t shift,
+                                   bool up)
+{
+        uint8_t *bytes = buf;
+
+        if (up)
+                memmove(bytes, bytes + shift * stride, (count - shift) * stride);
+        else
+                memmove(bytes + shift * stride, bytes, (count - shift) * stride);
+}
+
+bool rp2040_oled_scroll_vertical(rp2040_oled_t *oled, int8_t pages, bool render)
+{
+        uint8_t count = oled->height / PAGE_BITS;
+        uint8_t ring = rp2040_oled_ram_pages(oled);
+        uint8_t scroll_page = (oled->scroll_page + ring + pages % ring) % ring;
+        uint8_t shift = pages < 0 ? -pages : pages;
+        uint8_t first = pages < 0 ? 0 : count - shift;
+        uint8_t buf[3] = { 0x00 };
+        size_t len;
+
+        /* the framebuffer moves, it must not while the caller draws into it */
+        if (oled->hscroll.active || oled->fb_locked)
                 return false;
 
-        if (x < 0) {
-                width += x;
-                xshift = -x;
-                x = 0;
+        if (shift > count) {
+                shift = count;
+                first = 0;
         }
 
-        if (y < 0) {
-                height += y;
-                yshift = -y;
-                y = 0;
+        if (rp2040_oled_is_sh1107(oled)) {
+                buf[1] = OLED_CMD_SET_DISPLAY_STARTLINE;
+                buf[2] = scroll_page * PAGE_BITS;
+                len = 3;
+        } else {
+                buf[1] = OLED_CMD_SET_DISPLAY_STARTLINE0 | scroll_page * PAGE_BITS;
+                len = 2;
         }
 
-        if (x + width > oled->width)
-                width = oled->width - x;
+        /* with use_core1 this waits until core1 is done with the mirror */
+        if (shift != 0 && rp2040_oled_bus_write(oled, buf, len) != len)
+                return false;
 
-        if (y + height > oled->height)
-                height = oled->height - y;
-
-        orig_pages = (height + PAGE_BITS - 1) / PAGE_BITS;
-        final_pages = orig_pages;
-
-        if ((y % PAGE_BITS != 0) || yshift != 0) {
-                uint8_t yoffset = (y + yshift) % PAGE_BITS;
-                uint8_t pshift = yshift / PAGE_BITS;
-                final_pages = (height + yoffset + PAGE_BITS - 1) / PAGE_BITS;
-                osprite_size = orig_width * final_pages;
-                osprite = malloc(osprite_size);
-                memset(osprite, 0x00, osprite_size);
-                final_sprite = osprite;
-                for (uint8_t cur_page = 0; cur_page < final_pages; cur_page++) {
-                        for (uint8_t cur_x = 0; cur_x < orig_width; cur_x++) {
-                                if (y != 0) {
-                                        if ((cur_page) > 0)
-                                                osprite[cur_x + cur_page * orig_width] |= sprite[cur_x + (cur_page - 1) * orig_width] >> (PAGE_BITS - yoffset);
-
-                                        if (cur_page < orig_pages)
-                                                osprite[cur_x + cur_page * orig_width] |= sprite[cur_x + cur_page * orig_width] << yoffset;
-                                } else {
-                                        osprite[cur_x + cur_page * orig_width] |= sprite[cur_x + (pshift + cur_page) * orig_width] >> yoffset;
-
-                                        if (cur_page < orig_pages)
-                                                osprite[cur_x + cur_page * orig_width] |= sprite[cur_x + (pshift + cur_page + 1) * orig_width] << (PAGE_BITS - yoffset);
-                                }
-                        }
-                }
+        oled->scroll_page = scroll_page;
+
+        if (shift < count) {
+                uint16_t all = (1u << count) - 1;
+
+                rp2040_oled_move_pages(oled->gdram, oled->width, count, shift, pages > 0);
+                rp2040_oled_move_pages(oled->dirty_buf, oled->use_doublebuf ? oled->width :
+                                       (oled->width + 7) / 8, count, shift, pages > 0);
+                rp2040_oled_move_pages(oled->dirty_spans, sizeof(oled->dirty_spans[0]),
+                                       count, shift, pages > 0);
+                if (pages > 0)
+                        oled->dirty_pages = (oled->dirty_pages >> shift) & all;
+                else
+                        oled->dirty_pages = (oled->dirty_pages << shift) & all;
+        }
+
+        for (uint8_t page = first; page < first + shift; page++) {
+                uint8_t *fb = oled->use_doublebuf ? oled->dirty_buf : oled->gdram;
+
+                /* what RAM holds there was scrolled off earlier or never written */
+                memset(fb + page * oled->width, 0x00, oled->width);
+                rp2040_oled_invalidate_page(oled, page);
+        }
+
+        if (render)
+                return rp2040_oled_flush(oled);
+
+        return true;
+}
+
+bool rp2040_oled_scroll_stop(rp2040_oled_t *oled, bool render)
+{
+        uint8_t buf[] = { 0x00, OLED_CMD_SSD1306_SCROLL_STOP };
+
+        if (oled->hscroll.active) {
+                if (rp2040_oled_bus_write(oled, buf, sizeof(buf)) != sizeof(buf))
+                        return false;
+
+                for (uint8_t page = oled->hscroll.first; page <= oled->hscroll.last; page++)
+                        rp2040_oled_invalidate_page(oled, page);
+                oled->hscroll.active = false;
         }
 
-        buf_size = width;
-        buf = rp2040_oled_alloc_data_buf(buf_size);
+        if (render)
+                return rp2040_oled_flush(oled);
+
+        return true;
+}
+
+bool rp2040_oled_scroll_horizontal(rp2040_oled_t *oled, uint8_t first, uint8_t last,
+                                   bool left, rp2040_oled_scroll_speed_t speed)
+{
+        uint8_t buf[9];
+
+        if (oled->type != OLED_SSD1306_3C && oled->type != OLED_SSD1306_3D)
+                return false;
+        /* what is pending has to be on the panel before it moves */
+        if (oled->fb_locked)
+                return false;
+        if (first > last || last >= oled->height / PAGE_BITS ||
+            rp2040_oled_ram_page(oled, last) < rp2040_oled_ram_page(oled, first))
+                return false;
+
+        /* the controller has to be stopped before it is set up again */
+        if (!rp2040_oled_scroll_stop(oled, true))
+                return false;
+
+        buf[0] = 0x00;
+        buf[1] = left ? OLED_CMD_SSD1306_SCROLL_LEFT : OLED_CMD_SSD1306_SCROLL_RIGHT;
+        buf[2] = 0x00;
+        buf[3] = rp2040_oled_ram_page(oled, first);
+        buf[4] = speed;
+        buf[5] = rp2040_oled_ram_page(oled, last);
+        buf[6] = 0x00;
+        buf[7] = 0xff;
+        buf[8] = OLED_CMD_SSD1306_SCROLL_START;
+
+        if (rp2040_oled_bus_write(oled, buf, sizeof(buf)) != sizeof(buf))
+                return false;
+
+        oled->hscroll.active = true;
+        oled->hscroll.first = first;
+        oled->hscroll.last = last;
+
+        return true;
+}
+
+/* Clears row of the console and draws the line in slot into it */
+static bool rp2040_oled_console_draw(rp2040_oled_console_t *console, uint8_t row, uint8_t slot)
+{
+        rp2040_oled_t *oled = console->oled;
+
+        rp2040_oled_fill_span(oled, 0, oled->width - 1, row * PAGE_BITS,
+                              row * PAGE_BITS + PAGE_BITS - 1, OLED_COLOR_BLACK);
+
+        return rp2040_oled_write_string(oled, 0, row * PAGE_BITS, console->text[slot],
+                                        console->len[slot], false);
+}
+
+static bool rp2040_oled_console_line(rp2040_oled_console_t *console, const char *msg,
+                                     uint8_t len)
+{
+        uint8_t rows = console->oled->height / PAGE_BITS;
+        uint8_t row;
+
+        uint8_t slot;
+
+        if (console->count < rows) {
+                row = console->count++;
+        } else {
+                if (!rp2040_oled_scroll_vertical(console->oled, 1, false))
+                        return false;
+                console->head = (console->head + 1) % rows;
+                row = rows - 1;
+        }
+
+        slot = (console->head + row) % rows;
+        memcpy(console->text[slot], msg, len);
+        console->len[slot] = len;
+
+        return rp2040_oled_console_draw(console, row, slot);
+}
+
+void rp2040_oled_console_init(rp2040_oled_console_t *console, rp2040_oled_t *oled)
+{
+        memset(console, 0x00, sizeof(*console));
+        console->oled = oled;
+}
+
+bool rp2040_oled_console_write(rp2040_oled_console_t *console, const char *msg, size_t len,
+                               bool render)
+{
+        uint8_t columns = console->oled->width / 6;
+        size_t start = 0;
+
+        if (columns > RP2040_OLED_CONSOLE_COLUMNS)
+                columns = RP2040_OLED_CONSOLE_COLUMNS;
+
+        for (size_t i = 0; i <= len; i++) {
+                if (i < len && msg[i] != '\n' && i - start < columns)
+                        continue;
+
+                /* nothing after a trailing '\n' */
+                if ((i < len || i > start) &&
+                    !rp2040_oled_console_line(console, msg + start, i - start))
+                        return false;
+
+                start = i < len && msg[i] == '\n' ? i + 1 : i;
+        }
 
-        for (uint8_t cur_page = 0; cur_page < final_pages; cur_page++) {
-                if (!rp2040_oled_set_position(oled, x, y + cur_page * PAGE_BITS, false)) {
-                        ret = false;
-                        goto out;
+        if (render)
+                return rp2040_oled_flush(console->oled);
+
+        return true;
+}
+
+bool rp2040_oled_console_redraw(rp2040_oled_console_t *console, bool render)
+{
+        uint8_t rows = console->oled->height / PAGE_BITS;
+
+        for (uint8_t row = 0; row < rows; row++) {
+                if (row < console->count) {
+                        if (!rp2040_oled_console_draw(console, row, (console->head + row) % rows))
+                                return false;
+                } else {
+                        rp2040_oled_fill_span(console->oled, 0, console->oled->width - 1,
+                                              row * PAGE_BITS, row * PAGE_BITS + PAGE_BITS - 1,
+                                              OLED_COLOR_BLACK);
                 }
-                memcpy(buf, final_sprite + xshift + (cur_page * orig_width), width);
-                //memcpy(buf, final_sprite + xshift + ((yshift + cur_page) * orig_width), width);
-                if (cur_page == final_pages - 1 && (y + height) % PAGE_BITS) {
-                        uint8_t mask = 0x00;
-                        for (uint8_t i = 0; i < (y + height) % PAGE_BITS; i++) {
-                                mask |= 1 << i;
-                        }
+        }
+
+        if (render)
+                return rp2040_oled_flush(console->oled);
 
-                        for (uint8_t i = 0; i < width; i++) {
-                                *(buf + i) &= mask;
+        return true;
+}
+
+/* Fills shifted with data moved down by 1 to 7 rows, each copy pages + 1 pages high */
+static void rp2040_oled_sprite_shift(uint8_t *shifted, const uint8_t *data, uint8_t width,
+                                     uint8_t pages)
+{
+        for (uint8_t shift = 1; shift < PAGE_BITS; shift++) {
+                for (uint8_t page = 0; page <= pages; page++) {
+                        for (uint8_t x = 0; x < width; x++) {
+                                uint8_t bits = 0x00;
+
+                                if (page < pages)
+                                        bits |= data[page * width + x] << shift;
+                                if (page > 0)
+                                        bits |= data[(page - 1) * width + x] >> (PAGE_BITS - shift);
+                                *shifted++ = bits;
                         }
                 }
-                if (!rp2040_oled_write_gdram(oled, buf, buf_size, color, false)) {
-                        ret = false;
-                        goto out;
+        }
+}
+
+void rp2040_oled_sprite_init(rp2040_oled_sprite_t *sprite, const uint8_t *data, uint8_t width,
+                             uint8_t height, uint8_t *shifted)
+{
+        sprite->data = data;
+        sprite->width = width;
+        sprite->height = height;
+        sprite->shifted = shifted;
+        sprite->mask = NULL;
+        sprite->mask_shifted = NULL;
+
+        if (shifted)
+                rp2040_oled_sprite_shift(shifted, data, width,
+                                         (height + PAGE_BITS - 1) / PAGE_BITS);
+}
+
+void rp2040_oled_sprite_set_mask(rp2040_oled_sprite_t *sprite, const uint8_t *mask,
+                                 uint8_t *shifted)
+{
+        sprite->mask = mask;
+        sprite->mask_shifted = mask ? shifted : NULL;
+
+        if (mask && shifted)
+                rp2040_oled_sprite_shift(shifted, mask, sprite->width,
+                                         (sprite->height + PAGE_BITS - 1) / PAGE_BITS);
+}
+
+#define RP2040_OLED_BLIT_CHUNK 32
+
+/*
+ * count bytes from column x of page page of a sprite (or of its mask) moved
+ * down by shift rows. Points into the data or the shifted copies where it can,
+ * otherwise the bytes are shifted into buf.
+ */
+static const uint8_t *rp2040_oled_sprite_row(const uint8_t *data, const uint8_t *shifted,
+                                             uint8_t width, uint8_t pages, uint8_t shift,
+                                             uint8_t page, uint8_t x, uint8_t count,
+                                             uint8_t *buf)
+{
+        if (!shift)
+                return data + page * width + x;
+
+        if (shifted)
+                return shifted + ((shift - 1) * (pages + 1) + page) * width + x;
+
+        /* callers never ask for more, this lets the compiler see buf's bound */
+        if (count > RP2040_OLED_BLIT_CHUNK)
+                count = RP2040_OLED_BLIT_CHUNK;
+
+        for (uint8_t i = 0; i < count; i++) {
+                uint8_t bits = 0x00;
+
+                if (page < pages)
+                        bits |= data[page * width + x + i] << shift;
+                if (page > 0)
+                        bits |= data[(page - 1) * width + x + i] >> (PAGE_BITS - shift);
+                buf[i] = bits;
+        }
+
+        return buf;
+}
+
+static void rp2040_oled_blit(rp2040_oled_t *oled, const rp2040_oled_sprite_t *sprite, int16_t x,
+                             int16_t y, rp2040_oled_color_t color)
+{
+        uint8_t *gdram = oled->use_doublebuf ? oled->dirty_buf : oled->gdram;
+        uint8_t pages = (sprite->height + PAGE_BITS - 1) / PAGE_BITS;
+        /* page the top of the sprite is in and the rows it is moved down within it */
+        int16_t base = y >= 0 ? y / PAGE_BITS : -((PAGE_BITS - 1 - y) / PAGE_BITS);
+        uint8_t shift = y - base * PAGE_BITS;
+        int16_t x0 = x, x1 = x + sprite->width - 1;
+        int16_t y0 = y, y1 = y + sprite->height - 1;
+        /* shifted on the fly, placed to share the alignment of the destination */
+        uint32_t src_buf[RP2040_OLED_BLIT_CHUNK / 4 + 1];
+        uint32_t mask_buf[RP2040_OLED_BLIT_CHUNK / 4 + 1];
+
+        if (x0 < 0)
+                x0 = 0;
+        if (y0 < 0)
+                y0 = 0;
+        if (x1 >= oled->width)
+                x1 = oled->width - 1;
+        if (y1 >= oled->height)
+                y1 = oled->height - 1;
+
+        if (!sprite->width || !sprite->height || x0 > x1 || y0 > y1)
+                return;
+
+        for (uint8_t page = y0 / PAGE_BITS; page <= y1 / PAGE_BITS; page++) {
+                /* sprite page whose rows land in this page */
+                uint8_t src_page = page - base;
+                uint8_t rows = 0xff;
+
+                if (page == y0 / PAGE_BITS)
+                        rows &= 0xff << y0 % PAGE_BITS;
+                if (page == y1 / PAGE_BITS)
+                        rows &= 0xff >> (PAGE_BITS - 1 - y1 % PAGE_BITS);
+
+                for (int16_t col = x0; col <= x1; col += RP2040_OLED_BLIT_CHUNK) {
+                        uint8_t *dst = gdram + page * oled->width + col;
+                        uint8_t count = x1 - col + 1 < RP2040_OLED_BLIT_CHUNK ?
+                                        x1 - col + 1 : RP2040_OLED_BLIT_CHUNK;
+                        const uint8_t *src, *mask = NULL;
+
+                        src = rp2040_oled_sprite_row(sprite->data, sprite->shifted,
+                                                     sprite->width, pages, shift, src_page,
+                                                     col - x, count,
+                                                     (uint8_t *)src_buf + ((uintptr_t)dst & 3));
+                        if (sprite->mask)
+                                mask = rp2040_oled_sprite_row(sprite->mask, sprite->mask_shifted,
+                                                              sprite->width, pages, shift,
+                                                              src_page, col - x, count,
+                                                              (uint8_t *)mask_buf +
+                                                              ((uintptr_t)dst & 3));
+
+                        rp2040_oled_rop_row(dst, src, mask, count, rows, color);
                 }
+
+                rp2040_oled_touch(oled, page, x0, x1 - x0 + 1);
         }
+}
+
+bool rp2040_oled_blit_sprite(rp2040_oled_t *oled, const rp2040_oled_sprite_t *sprite, int16_t x,
+                             int16_t y, rp2040_oled_color_t color, bool render)
+{
+        if (color > OLED_COLOR_INVERT)
+                return false;
+
+        rp2040_oled_blit(oled, sprite, x, y, color);
 
         if (render)
                 rp2040_oled_flush(oled);
 
-out:
-        rp2040_oled_free_data_buf(buf);
-        if (osprite)
-                free(osprite);
-        return ret;
+        return true;
 }
 
-bool rp2040_oled_draw_sprite_pitched(rp2040_oled_t *oled, uint8_t *sprite, int16_t x,
-                                     int16_t y, uint8_t width, uint8_t height, uint8_t pitch,
-                                     rp2040_oled_color_t color, bool render)
+/*
+ * Transposes an 8x8 block of a row-major bitmap, rows pitch bytes apart with
+ * the MSB leftmost, into 8 page bytes with bit 0 the top row. This is the
+ * shift and mask transpose from Hacker's Delight; rows are loaded bottom up
+ * so the bit order comes out the way pages want it. Rows past rows read as
+ * empty.
+ */
+static void rp2040_oled_transpose8(const uint8_t *src, size_t pitch, uint8_t rows, uint8_t *out)
 {
-        bool ret = true;
-        uint8_t *mem_sprite = NULL;
-        size_t mem_sprite_size = width * ((height + PAGE_BITS - 1) / PAGE_BITS);
-
-        mem_sprite = malloc(mem_sprite_size);
-        memset(mem_sprite, 0x00, mem_sprite_size);
-
-        for (uint8_t cy = 0; cy < height; cy++) {
-                uint8_t cpage = cy / PAGE_BITS;
-                uint8_t sx = 0;
-                uint8_t *src = sprite + (cy * pitch);
-                uint8_t *dst = mem_sprite + (cpage * width);
-                uint8_t src_mask = 0x80;
-                uint8_t dst_mask = 1 << (cy & (PAGE_BITS - 1));
-                for (uint8_t dx = 0; dx < width; dx++) {
-                        if (*(src + sx) & src_mask)
-                                *(dst + dx) |= dst_mask;
-                        src_mask >>= 1;
-                        if (!src_mask) {
-                                src_mask = 0x80;
-                                sx++;
-                        }
-                }
+        uint32_t x = 0, y = 0, t;
+
+        for (uint8_t i = 0; i < rows; i++) {
+                if (i < 4)
+                        y |= (uint32_t)src[i * pitch] << (8 * i);
+                else
+                        x |= (uint32_t)src[i * pitch] << (8 * (i - 4));
         }
 
-        ret = rp2040_oled_draw_sprite(oled, mem_sprite, x, y, width, height, color, render);
-        free(mem_sprite);
-        return ret;
+        t = (x ^ (x >> 7)) & 0x00aa00aa;
+        x = x ^ t ^ (t << 7);
+        t = (y ^ (y >> 7)) & 0x00aa00aa;
+        y = y ^ t ^ (t << 7);
+
+        t = (x ^ (x >> 14)) & 0x0000cccc;
+        x = x ^ t ^ (t << 14);
+        t = (y ^ (y >> 14)) & 0x0000cccc;
+        y = y ^ t ^ (t << 14);
+
+        t = (x & 0xf0f0f0f0) | ((y >> 4) & 0x0f0f0f0f);
+        y = ((x << 4) & 0xf0f0f0f0) | (y & 0x0f0f0f0f);
+        x = t;
+
+        out[0] = x >> 24;
+        out[1] = x >> 16;
+        out[2] = x >> 8;
+        out[3] = x;
+        out[4] = y >> 24;
+        out[5] = y >> 16;
+        out[6] = y >> 8;
+        out[7] = y;
 }
 
-bool rp2040_oled_draw_circle(rp2040_oled_t *oled, int16_t x, int16_t y, uint8_t r,
-                             rp2040_oled_color_t color, bool fill, bool render)
+/* count columns from column x (a multiple of 8) of up to 8 bitmap rows to page bytes */
+static void rp2040_oled_convert_strip(const uint8_t *src, uint8_t pitch, uint8_t rows,
+                                      uint8_t x, uint8_t count, uint8_t *dst)
 {
-        uint8_t dx = r, dy = 0;
-        int16_t t1 = r / 16;
-        int16_t t2;
+        uint8_t block[PAGE_BITS];
 
-        while (dx >= dy) {
-                if (fill) {
-                        rp2040_oled_draw_line(oled, x + dx, y + dy, x + dx, y - dy, color, false);
-                        rp2040_oled_draw_line(oled, x - dx, y + dy, x - dx, y - dy, color, false);
-                        rp2040_oled_draw_line(oled, x + dy, y + dx, x + dy, y - dx, color, false);
-                        rp2040_oled_draw_line(oled, x - dy, y + dx, x - dy, y - dx, color, false);
-                } else {
-                        rp2040_oled_set_pixel(oled, x + dx, y + dy, color, false);
-                        rp2040_oled_set_pixel(oled, x + dx, y - dy, color, false);
-                        rp2040_oled_set_pixel(oled, x - dx, y + dy, color, false);
-                        rp2040_oled_set_pixel(oled, x - dx, y - dy, color, false);
-                        rp2040_oled_set_pixel(oled, x + dy, y + dx, color, false);
-                        rp2040_oled_set_pixel(oled, x + dy, y - dx, color, false);
-                        rp2040_oled_set_pixel(oled, x - dy, y + dx, color, false);
-                        rp2040_oled_set_pixel(oled, x - dy, y - dx, color, false);
-                }
+        for (uint8_t bx = 0; bx < count; bx += PAGE_BITS) {
+                rp2040_oled_transpose8(src + (x + bx) / 8, pitch, rows, block);
+                memcpy(dst + bx, block, count - bx < PAGE_BITS ? count - bx : PAGE_BITS);
+        }
+}
+
+void rp2040_oled_sprite_convert(uint8_t *dst, const uint8_t *src, uint8_t width, uint8_t height,
+                                uint8_t pitch)
+{
+        for (uint8_t page = 0; page * PAGE_BITS < height; page++) {
+                uint8_t rows = height - page * PAGE_BITS;
+
+                rp2040_oled_convert_strip(src + page * PAGE_BITS * pitch, pitch,
+                                          rows < PAGE_BITS ? rows : PAGE_BITS, 0, width,
+                                          dst + page * width);
+        }
+}
+
+/*
+ * Blits a row-major bitmap a page high strip of up to RP2040_OLED_BLIT_CHUNK
+ * columns at a time, converting each strip on the stack first.
+ */
+static void rp2040_oled_blit_rows(rp2040_oled_t *oled, const uint8_t *bitmap, int16_t x,
+                                  int16_t y, uint8_t width, uint8_t height, uint8_t pitch,
+                                  rp2040_oled_color_t color)
+{
+        uint32_t buf[RP2040_OLED_BLIT_CHUNK / 4];
+        rp2040_oled_sprite_t strip;
+
+        for (uint8_t page = 0; page * PAGE_BITS < height; page++) {
+                int16_t top = y + page * PAGE_BITS;
+                uint8_t rows = height - page * PAGE_BITS;
+
+                if (rows > PAGE_BITS)
+                        rows = PAGE_BITS;
+                if (top + rows <= 0 || top >= oled->height)
+                        continue;
+
+                for (uint16_t cx = 0; cx < width; cx += RP2040_OLED_BLIT_CHUNK) {
+                        uint8_t count = width - cx < RP2040_OLED_BLIT_CHUNK ?
+                                        width - cx : RP2040_OLED_BLIT_CHUNK;
 
-                dy++;
-                t1 += dy;
-                t2 = t1 - dx;
-                if (t2 >= 0) {
-                        t1 = t2;
-                        dx--;
+                        if (x + cx + count <= 0 || x + cx >= oled->width)
+                                continue;
+
+                        rp2040_oled_convert_strip(bitmap + page * PAGE_BITS * pitch, pitch, rows,
+                                                  cx, count, (uint8_t *)buf);
+                        rp2040_oled_sprite_init(&strip, (uint8_t *)buf, count, rows, NULL);
+                        rp2040_oled_blit(oled, &strip, x + cx, top, color);
                 }
         }
+}
+
+bool rp2040_oled_draw_sprite(rp2040_oled_t *oled, const uint8_t *sprite, int16_t x,
+                             int16_t y, uint8_t width, uint8_t height,
+                             rp2040_oled_color_t color, bool render)
+{
+        rp2040_oled_sprite_t prepared;
+
+        if (x + width < 0 || y + height < 0)
+                return false;
+
+        rp2040_oled_sprite_init(&prepared, sprite, width, height, NULL);
+
+        return rp2040_oled_blit_sprite(oled, &prepared, x, y, color, render);
+}
+
+bool rp2040_oled_draw_sprite_pitched(rp2040_oled_t *oled, uint8_t *sprite, int16_t x,
+                                     int16_t y, uint8_t width, uint8_t height, uint8_t pitch,
+                                     rp2040_oled_color_t color, bool render)
+{
+        if (x + width < 0 || y + height < 0 || color > OLED_COLOR_INVERT)
+                return false;
+
+        rp2040_oled_blit_rows(oled, sprite, x, y, width, height, pitch, color);
 
         if (render)
                 rp2040_oled_flush(oled);
@@ -618,78 +1832,283 @@ bool rp2040_oled_draw_circle(rp2040_oled_t *oled, int16_t x, int16_t y, uint8_t
         return true;
 }
 
-bool rp2040_oled_draw_ellipse(rp2040_oled_t *oled, int16_t x, int16_t y, uint8_t rx,
-                              uint8_t ry, rp2040_oled_color_t color, bool fill,
-                              bool render)
+bool rp2040_oled_set_pixels_bitmap(rp2040_oled_t *oled, int16_t x, int16_t y,
+                                   const uint8_t *bitmap, uint8_t width, uint8_t height,
+                                   uint8_t pitch, rp2040_oled_color_t color, bool render)
 {
-        float dx, dy, d1, d2;
-        int16_t sx, sy;
-        int32_t rx2, ry2;
+        if (color != OLED_COLOR_WHITE && color != OLED_COLOR_BLACK)
+                return false;
 
-        if (rx == ry)
-                return rp2040_oled_draw_circle(oled, x, y, rx, color, fill, render);
+        rp2040_oled_blit_rows(oled, bitmap, x, y, width, height, pitch,
+                              color == OLED_COLOR_WHITE ? OLED_COLOR_WHITE : OLED_COLOR_AND_NOT);
 
-        sx = 0;
-        sy = ry;
+        if (render)
+                return rp2040_oled_flush(oled);
 
-        rx2 = rx * rx;
-        ry2 = ry * ry;
+        return true;
+}
 
-        d1 = ry2 - (rx2 * ry) + (0.25 * rx2);
-        dx = 2 * ry2 * sx;
-        dy = 2 * rx2 * sy;
+/* sin() of whole degrees 0-90, times 1024 */
+static const int16_t rp2040_oled_sin_table[] = {
+        0, 18, 36, 54, 71, 89, 107, 125, 143, 160, 178, 195,
+        213, 230, 248, 265, 282, 299, 316, 333, 350, 367, 384, 400,
+        416, 433, 449, 465, 481, 496, 512, 527, 543, 558, 573, 587,
+        602, 616, 630, 644, 658, 672, 685, 698, 711, 724, 737, 749,
+        761, 773, 784, 796, 807, 818, 828, 839, 849, 859, 868, 878,
+        887, 896, 904, 912, 920, 928, 935, 943, 949, 956, 962, 968,
+        974, 979, 984, 989, 994, 998, 1002, 1005, 1008, 1011, 1014, 1016,
+        1018, 1020, 1022, 1023, 1023, 1024, 1024,
+};
+
+static int16_t rp2040_oled_sin(int16_t deg)
+{
+        deg %= 360;
+        if (deg < 0)
+                deg += 360;
+
+        if (deg <= 90)
+                return rp2040_oled_sin_table[deg];
+        if (deg <= 180)
+                return rp2040_oled_sin_table[180 - deg];
+        if (deg <= 270)
+                return -rp2040_oled_sin_table[deg - 180];
+        return -rp2040_oled_sin_table[360 - deg];
+}
 
-        while (dx < dy) {
-                if (fill) {
-                        rp2040_oled_draw_line(oled, x + sx, y - sy, x + sx, y + sy, color, false);
-                        rp2040_oled_draw_line(oled, x - sx, y - sy, x - sx, y + sy, color, false);
-                } else {
-                        rp2040_oled_set_pixel(oled, x + sx, y - sy, color, false);
-                        rp2040_oled_set_pixel(oled, x + sx, y + sy, color, false);
-                        rp2040_oled_set_pixel(oled, x - sx, y - sy, color, false);
-                        rp2040_oled_set_pixel(oled, x - sx, y + sy, color, false);
-                }
+/*
+ * A curve is a quarter ellipse mirrored around up to four centres: columns
+ * xl and xr split it into its left and right half, rows yt and yb into its top
+ * and bottom half. With all centres the same it is a plain ellipse, pulled
+ * apart it is a rounded rectangle. Curves are drawn a column at a time.
+ */
+typedef struct {
+        int16_t             xl, xr;
+        int16_t             yt, yb;
+        bool                fill;
+        rp2040_oled_color_t color;
+        /* arcs keep only the pixels between the start and end directions */
+        bool                arc;
+        bool                wide;
+        int32_t             sx, sy;
+        int32_t             ex, ey;
+        rp2040_oled_batch_t batch;
+} rp2040_oled_curve_t;
+
+static bool rp2040_oled_arc_contains(rp2040_oled_curve_t *curve, int32_t dx, int32_t dy)
+{
+        /* cross products are positive for points clockwise of a direction */
+        bool after_start = curve->sx * dy - curve->sy * dx >= 0;
+        bool before_end = dx * curve->ey - dy * curve->ex >= 0;
+
+        if (!curve->wide)
+                return after_start && before_end;
 
-                if (d1 < 0) {
-                        sx++;
-                        dx = dx + (2 * ry2);
-                        d1 = d1 + dx + ry2;
+        return after_start || before_end;
+}
+
+static void rp2040_oled_arc_span(rp2040_oled_t *oled, rp2040_oled_curve_t *curve, int16_t x,
+                                 int16_t y0, int16_t y1)
+{
+        for (int16_t y = y0; y <= y1; y++) {
+                if (rp2040_oled_arc_contains(curve, x - curve->xl, y - curve->yt))
+                        rp2040_oled_plot(oled, &curve->batch, x, y, curve->color);
+        }
+}
+
+static void rp2040_oled_curve_span(rp2040_oled_t *oled, rp2040_oled_curve_t *curve, int16_t x,
+                                   int16_t y0, int16_t y1)
+{
+        if (curve->arc)
+                rp2040_oled_arc_span(oled, curve, x, y0, y1);
+        else
+                rp2040_oled_fill_clipped(oled, x, x, y0, y1, curve->color);
+}
+
+/*
+ * Column dx out from the centres, where the outline covers rows ylo to yhi
+ * out from the centres. Each resulting span is drawn exactly once.
+ */
+static void rp2040_oled_curve_column(rp2040_oled_t *oled, rp2040_oled_curve_t *curve,
+                                     int16_t dx, int16_t ylo, int16_t yhi)
+{
+        int16_t cols[2] = { curve->xl - dx, curve->xr + dx };
+
+        for (uint8_t i = 0; i < 2; i++) {
+                if (i == 1 && cols[1] == cols[0])
+                        break;
+
+                /* the outline reaching the centre row includes the side edge */
+                if (curve->fill || ylo == 0) {
+                        rp2040_oled_curve_span(oled, curve, cols[i], curve->yt - yhi,
+                                               curve->yb + yhi);
                 } else {
-                        sx++;
-                        sy--;
-                        dx = dx + (2 * ry2);
-                        dy = dy - (2 * rx2);
-                        d1 = d1 + dx - dy + ry2;
+                        rp2040_oled_curve_span(oled, curve, cols[i], curve->yt - yhi,
+                                               curve->yt - ylo);
+                        rp2040_oled_curve_span(oled, curve, cols[i], curve->yb + ylo,
+                                               curve->yb + yhi);
                 }
         }
+}
 
-        d2 = (ry2 * ((sx + 0.5) * (sx + 0.5))) + (rx2 * ((sy - 1) * (sy - 1))) - (rx2 * ry2);
-        while (sy >= 0) {
-                if (fill) {
-                        rp2040_oled_draw_line(oled, x + sx, y - sy, x + sx, y + sy, color, false);
-                        rp2040_oled_draw_line(oled, x - sx, y - sy, x - sx, y + sy, color, false);
+/*
+ * Integer midpoint ellipse from (0, ry) to (rx, 0), the decision variables are
+ * kept times four so there are no fractions. Points are gathered into columns
+ * as they come, y only ever goes down.
+ */
+static void rp2040_oled_curve_walk(rp2040_oled_t *oled, rp2040_oled_curve_t *curve, uint8_t rx,
+                                   uint8_t ry)
+{
+        int32_t rx2 = rx * rx;
+        int32_t ry2 = ry * ry;
+        int32_t x = 0, y = ry;
+        int32_t px = 0, py = 2 * rx2 * y;
+        int16_t col = 0, lo = ry, hi = ry;
+        int32_t p;
+
+        if (ry == 0) {
+                for (int16_t dx = 0; dx <= rx; dx++)
+                        rp2040_oled_curve_column(oled, curve, dx, 0, 0);
+                return;
+        }
+
+#define VISIT()                                                                         \
+        do {                                                                            \
+                if (x != col) {                                                         \
+                        rp2040_oled_curve_column(oled, curve, col, lo, hi);             \
+                        col = x;                                                        \
+                        hi = y;                                                         \
+                }                                                                       \
+                lo = y;                                                                 \
+        } while (0)
+
+        p = 4 * ry2 - 4 * rx2 * ry + rx2;
+        while (px < py) {
+                VISIT();
+                x++;
+                px += 2 * ry2;
+                if (p < 0) {
+                        p += 4 * (ry2 + px);
                 } else {
-                        rp2040_oled_set_pixel(oled, x + sx, y - sy, color, false);
-                        rp2040_oled_set_pixel(oled, x + sx, y + sy, color, false);
-                        rp2040_oled_set_pixel(oled, x - sx, y - sy, color, false);
-                        rp2040_oled_set_pixel(oled, x - sx, y + sy, color, false);
+                        y--;
+                        py -= 2 * rx2;
+                        p += 4 * (ry2 + px - py);
                 }
+        }
 
-                if (d2 > 0) {
-                        sy--;
-                        dy = dy - (2 * rx2);
-                        d2 = d2 + rx2 - dy;
+        p = (int64_t)ry2 * (2 * x + 1) * (2 * x + 1) + 4 * (int64_t)rx2 * (y - 1) * (y - 1) -
+            4 * (int64_t)rx2 * ry2;
+        while (y >= 0) {
+                VISIT();
+                y--;
+                py -= 2 * rx2;
+                if (p > 0) {
+                        p += 4 * (rx2 - py);
                 } else {
-                        sy--;
-                        sx++;
-                        dx = dx + (2 * ry2);
-                        dy = dy - (2 * rx2);
-                        d2 = d2 + dx - dy + rx2;
+                        x++;
+                        px += 2 * ry2;
+                        p += 4 * (rx2 - py + px);
                 }
         }
+#undef VISIT
+
+        rp2040_oled_curve_column(oled, curve, col, lo, hi);
+}
+
+static bool rp2040_oled_draw_curve(rp2040_oled_t *oled, rp2040_oled_curve_t *curve, uint8_t rx,
+                                   uint8_t ry, bool render)
+{
+        if (curve->color != OLED_COLOR_WHITE && curve->color != OLED_COLOR_BLACK)
+                return false;
+
+        rp2040_oled_batch_init(oled, &curve->batch);
+        rp2040_oled_curve_walk(oled, curve, rx, ry);
+        rp2040_oled_batch_commit(oled, &curve->batch);
 
         if (render)
                 rp2040_oled_flush(oled);
 
         return true;
 }
+
+bool rp2040_oled_draw_circle(rp2040_oled_t *oled, int16_t x, int16_t y, uint8_t r,
+                             rp2040_oled_color_t color, bool fill, bool render)
+{
+        return rp2040_oled_draw_ellipse(oled, x, y, r, r, color, fill, render);
+}
+
+bool rp2040_oled_draw_ellipse(rp2040_oled_t *oled, int16_t x, int16_t y, uint8_t rx,
+                              uint8_t ry, rp2040_oled_color_t color, bool fill,
+                              bool render)
+{
+        rp2040_oled_curve_t curve = { .xl = x, .xr = x, .yt = y, .yb = y, .fill = fill,
+                                      .color = color };
+
+        return rp2040_oled_draw_curve(oled, &curve, rx, ry, render);
+}
+
+bool rp2040_oled_draw_rounded_rectangle(rp2040_oled_t *oled, uint8_t x0, uint8_t y0,
+                                        uint8_t x1, uint8_t y1, uint8_t r,
+                                        rp2040_oled_color_t color, bool fill, bool render)
+{
+        rp2040_oled_curve_t curve = { .fill = fill, .color = color };
+        uint8_t tmp;
+
+        if (color != OLED_COLOR_WHITE && color != OLED_COLOR_BLACK)
+                return false;
+
+        if (x0 > x1) {
+                tmp = x0;
+                x0 = x1;
+                x1 = tmp;
+        }
+
+        if (y0 > y1) {
+                tmp = y0;
+                y0 = y1;
+                y1 = tmp;
+        }
+
+        if (r > (x1 - x0) / 2)
+                r = (x1 - x0) / 2;
+        if (r > (y1 - y0) / 2)
+                r = (y1 - y0) / 2;
+
+        curve.xl = x0 + r;
+        curve.xr = x1 - r;
+        curve.yt = y0 + r;
+        curve.yb = y1 - r;
+
+        /* the columns between the corners */
+        if (curve.xr - curve.xl > 1) {
+                if (fill) {
+                        rp2040_oled_fill_clipped(oled, curve.xl + 1, curve.xr - 1, y0, y1, color);
+                } else {
+                        rp2040_oled_fill_clipped(oled, curve.xl + 1, curve.xr - 1, y0, y0, color);
+                        if (y1 != y0)
+                                rp2040_oled_fill_clipped(oled, curve.xl + 1, curve.xr - 1, y1, y1,
+                                                         color);
+                }
+        }
+
+        return rp2040_oled_draw_curve(oled, &curve, r, r, render);
+}
+
+bool rp2040_oled_draw_arc(rp2040_oled_t *oled, int16_t x, int16_t y, uint8_t rx, uint8_t ry,
+                          int16_t start, int16_t end, rp2040_oled_color_t color, bool render)
+{
+        rp2040_oled_curve_t curve = { .xl = x, .xr = x, .yt = y, .yb = y, .color = color,
+                                      .arc = true };
+        int16_t sweep = end - start;
+
+        if (sweep >= 360 || sweep <= -360)
+                return rp2040_oled_draw_ellipse(oled, x, y, rx, ry, color, false, render);
+
+        sweep = (sweep + 360) % 360;
+        curve.wide = sweep > 180;
+        curve.sx = rp2040_oled_sin(start + 90);
+        curve.sy = rp2040_oled_sin(start);
+        curve.ex = rp2040_oled_sin(start + sweep + 90);
+        curve.ey = rp2040_oled_sin(start + sweep);
+
+        return rp2040_oled_draw_curve(oled, &curve, rx, ry, render);
+}
@@ -6,3 +6,7 @@
 #include "include/rp2040-oled.h"
 
 bool rp2040_oled_force_flush(rp2040_oled_t *oled);
+void rp2040_oled_get_offset(rp2040_oled_t *oled, uint8_t *x, uint8_t *page);
+void rp2040_oled_flush_diff(rp2040_oled_t *oled, const uint8_t *back, uint16_t pages,
+                            const rp2040_oled_span_t *spans);
+void rp2040_oled_flush_complete(rp2040_oled_t *oled, bool ok);
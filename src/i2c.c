@@ -3,9 +3,246 @@
  * Copyright 2023, Artem Savkov
  */
 
-#include <string.h>
+#include "hardware/dma.h"
+#include "hardware/irq.h"
 
 #include "i2c.h"
+#include "gfx.h"
+#include "async.h"
+
+static rp2040_oled_t *rp2040_i2c_dma_oled[NUM_DMA_CHANNELS];
+/* display whose queue is on the bus, per I2C block */
+static rp2040_oled_t *rp2040_i2c_irq_oled[NUM_I2CS];
+
+/* Same as i2c_write_blocking() addressing, the target may have changed since */
+static void rp2040_i2c_set_target(rp2040_oled_t *oled)
+{
+        i2c_hw_t *hw = i2c_get_hw(oled->i2c);
+
+        hw->enable = 0;
+        hw->tar = oled->addr;
+        hw->enable = 1;
+}
+
+/* Queues one IC_DATA_CMD word, or pushes it to the TX FIFO right away */
+static bool rp2040_i2c_emit(rp2040_oled_t *oled, uint16_t word)
+{
+        i2c_hw_t *hw = i2c_get_hw(oled->i2c);
+
+        if (oled->async.recording) {
+                if (oled->async.len >= oled->async.size) {
+                        oled->async.overflow = true;
+                        return false;
+                }
+
+                oled->async.buf[oled->async.len++] = word;
+                return true;
+        }
+
+        while (!i2c_get_write_available(oled->i2c)) {
+                if (hw->tx_abrt_source)
+                        return false;
+        }
+        hw->data_cmd = word;
+
+        return true;
+}
+
+static void rp2040_i2c_dma_irq_handler(void)
+{
+        for (uint i = 0; i < NUM_DMA_CHANNELS; i++) {
+                rp2040_oled_t *oled = rp2040_i2c_dma_oled[i];
+
+                if (!oled || !dma_channel_get_irq0_status(i))
+                        continue;
+
+                /* DMA is done once the last word is in the FIFO, not on the wire */
+                dma_channel_acknowledge_irq0(i);
+                i2c_get_hw(oled->i2c)->intr_mask = I2C_IC_INTR_MASK_M_STOP_DET_BITS |
+                                                   I2C_IC_INTR_MASK_M_TX_ABRT_BITS;
+        }
+}
+
+/*
+ * Every split ends with a stop, so the transfer is only over at a stop with
+ * the FIFO empty and the master idle. A NACK aborts it: the FIFO is flushed,
+ * so the rest of the queue is dropped and the flush reported as failed.
+ */
+static void rp2040_i2c_irq_handler(void)
+{
+        for (uint i = 0; i < NUM_I2CS; i++) {
+                rp2040_oled_t *oled = rp2040_i2c_irq_oled[i];
+                bool aborted;
+                i2c_hw_t *hw;
+
+                if (!oled)
+                        continue;
+
+                hw = i2c_get_hw(oled->i2c);
+                if (!hw->intr_stat)
+                        continue;
+
+                aborted = hw->intr_stat & I2C_IC_INTR_STAT_R_TX_ABRT_BITS;
+                if (aborted) {
+                        /* an abort may raise the channel interrupt on its own */
+                        dma_channel_set_irq0_enabled(oled->async.dma_chan, false);
+                        dma_channel_abort(oled->async.dma_chan);
+                        dma_channel_acknowledge_irq0(oled->async.dma_chan);
+                        dma_channel_set_irq0_enabled(oled->async.dma_chan, true);
+                        (void)hw->clr_tx_abrt;
+                }
+
+                (void)hw->clr_stop_det;
+                if (!aborted && (!(hw->status & I2C_IC_STATUS_TFE_BITS) ||
+                                 (hw->status & I2C_IC_STATUS_MST_ACTIVITY_BITS)))
+                        continue;
+
+                hw->intr_mask = 0;
+                rp2040_i2c_irq_oled[i] = NULL;
+                oled->async.busy = false;
+                rp2040_oled_flush_complete(oled, !aborted);
+        }
+}
+
+static bool rp2040_i2c_async_begin(rp2040_oled_t *oled)
+{
+        static bool irq_installed = false;
+        static bool i2c_irq_installed[NUM_I2CS];
+        uint i2c_index = i2c_hw_index(oled->i2c);
+
+        if (!rp2040_oled_async_prepare(oled, oled->max_transfer))
+                return false;
+
+        rp2040_oled_async_claim_dma(oled, rp2040_i2c_dma_oled, rp2040_i2c_dma_irq_handler,
+                                    &irq_installed);
+
+        if (!i2c_irq_installed[i2c_index]) {
+                /* everything is unmasked out of reset */
+                i2c_get_hw(oled->i2c)->intr_mask = 0;
+                irq_add_shared_handler(I2C0_IRQ + i2c_index, rp2040_i2c_irq_handler,
+                                       PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+                irq_set_enabled(I2C0_IRQ + i2c_index, true);
+                i2c_irq_installed[i2c_index] = true;
+        }
+
+        rp2040_oled_async_record(oled);
+
+        return true;
+}
+
+static bool rp2040_i2c_async_submit(rp2040_oled_t *oled)
+{
+        i2c_hw_t *hw = i2c_get_hw(oled->i2c);
+        dma_channel_config cfg;
+
+        oled->async.recording = false;
+
+        if (oled->async.overflow)
+                return false;
+
+        if (oled->async.len == 0) {
+                rp2040_oled_flush_complete(oled, true);
+                return true;
+        }
+
+        rp2040_i2c_set_target(oled);
+
+        cfg = dma_channel_get_default_config(oled->async.dma_chan);
+        channel_config_set_transfer_data_size(&cfg, DMA_SIZE_16);
+        channel_config_set_read_increment(&cfg, true);
+        channel_config_set_write_increment(&cfg, false);
+        channel_config_set_dreq(&cfg, i2c_get_dreq(oled->i2c, true));
+
+        /* left over from a synchronous transfer, it would end this one right away */
+        if (hw->tx_abrt_source)
+                (void)hw->clr_tx_abrt;
+
+        rp2040_i2c_irq_oled[i2c_hw_index(oled->i2c)] = oled;
+        hw->intr_mask = I2C_IC_INTR_MASK_M_TX_ABRT_BITS;
+        oled->async.busy = true;
+        dma_channel_configure(oled->async.dma_chan, &cfg, &hw->data_cmd, oled->async.buf,
+                              oled->async.len, true);
+
+        return true;
+}
+
+/* Waits for pushed words to leave, false if the target did not ack them */
+static bool rp2040_i2c_finish(rp2040_oled_t *oled)
+{
+        i2c_hw_t *hw = i2c_get_hw(oled->i2c);
+        bool aborted;
+
+        while (!(hw->status & I2C_IC_STATUS_TFE_BITS) ||
+               (hw->status & I2C_IC_STATUS_MST_ACTIVITY_BITS)) {
+                if (hw->tx_abrt_source)
+                        break;
+        }
+
+        aborted = hw->tx_abrt_source != 0;
+        if (aborted)
+                (void)hw->clr_tx_abrt;
+
+        oled->i2c->restart_on_next = false;
+
+        return !aborted;
+}
+
+/*
+ * Sends the control byte followed by rows of payload as a single transaction.
+ * With max_transfer set the payload is split instead, repeating the control
+ * byte at the start of every piece.
+ */
+static bool rp2040_i2c_stream(rp2040_oled_t *oled, uint8_t control, const uint8_t *data,
+                              size_t width, size_t rows, size_t stride)
+{
+        size_t size = width * rows;
+        size_t chunk = oled->max_transfer > 1 ? oled->max_transfer - 1u : size;
+        size_t sent = 0;
+
+        if (!oled->async.recording) {
+                rp2040_oled_async_wait(oled);
+                rp2040_i2c_set_target(oled);
+        }
+
+        if (size == 0 && !rp2040_i2c_emit(oled, control | I2C_IC_DATA_CMD_RESTART_BITS |
+                                          I2C_IC_DATA_CMD_STOP_BITS))
+                goto out;
+
+        for (size_t row = 0; row < rows; row++) {
+                for (size_t col = 0; col < width; col++) {
+                        bool last = (sent + 1) % chunk == 0 || sent + 1 == size;
+
+                        if (sent % chunk == 0 &&
+                            !rp2040_i2c_emit(oled, control | I2C_IC_DATA_CMD_RESTART_BITS))
+                                goto out;
+
+                        if (!rp2040_i2c_emit(oled, data[row * stride + col] |
+                                             (last ? I2C_IC_DATA_CMD_STOP_BITS : 0)))
+                                goto out;
+
+                        sent++;
+                }
+        }
+
+out:
+        if (!oled->async.recording && !rp2040_i2c_finish(oled))
+                return false;
+
+        return sent == size;
+}
+
+/*
+ * Sends GDRAM rows in place, the control byte comes from here rather than
+ * from a copy of the data with a free byte in front.
+ */
+static size_t rp2040_i2c_write_data(rp2040_oled_t *oled, const uint8_t *data, uint8_t width,
+                                    uint8_t rows, size_t stride)
+{
+        if (!rp2040_i2c_stream(oled, OLED_CB_DATA_BIT, data, width, rows, stride))
+                return 0;
+
+        return width * rows;
+}
 
 void rp2040_i2c_init(rp2040_oled_t *oled)
 {
@@ -16,6 +253,9 @@ void rp2040_i2c_init(rp2040_oled_t *oled)
 
         gpio_pull_up(oled->sda_pin);
         gpio_pull_up(oled->scl_pin);
+
+        /* claimed on the first rp2040_oled_flush_async() */
+        oled->async.dma_chan = -1;
 }
 
 bool rp2040_i2c_test_addr(rp2040_oled_t *oled, uint8_t addr)
@@ -23,6 +263,8 @@ bool rp2040_i2c_test_addr(rp2040_oled_t *oled, uint8_t addr)
         uint8_t buf;
         int ret;
 
+        rp2040_oled_async_wait(oled);
+
         ret = i2c_read_blocking(oled->i2c, addr, &buf, 1, false);
         return ret != PICO_ERROR_GENERIC;
 }
@@ -31,6 +273,8 @@ int rp2040_i2c_read_register(rp2040_oled_t *oled, uint8_t reg, uint8_t *data, si
 {
         int ret;
 
+        rp2040_oled_async_wait(oled);
+
         ret = i2c_write_blocking(oled->i2c, oled->addr, &reg, 1, true);
         if (ret < 0)
                 return ret;
@@ -41,39 +285,24 @@ int rp2040_i2c_read_register(rp2040_oled_t *oled, uint8_t reg, uint8_t *data, si
 
 size_t rp2040_i2c_write(rp2040_oled_t *oled, const uint8_t *data, size_t len)
 {
-        uint8_t buf[32];
-        size_t sent = 0;
-        size_t ret = 0;
-        uint8_t leftover;
-        while (len - sent >= 32) {
-                if (sent == 0) {
-                        memcpy(buf, data, 32);
-                        data += 32;
-                        sent += 32;
-                } else {
-                        buf[0] = OLED_CB_DATA_BIT;
-                        memcpy(buf + 1, data, 31);
-                        data += 31;
-                        sent += 31;
-                }
-                ret = i2c_write_blocking(oled->i2c, oled->addr, buf, 32, true);
-        }
+        if (len == 0)
+                return 0;
 
-        leftover = len - sent;
-        if (leftover == len) {
-                ret = i2c_write_blocking(oled->i2c, oled->addr, data, len, true);
-                return ret == len ? ret : -1;
+        if (!rp2040_i2c_stream(oled, data[0], data + 1, len - 1, 1, len - 1))
+                return -1;
 
-        }
-        if (leftover > 0) {
-                buf[0] = OLED_CB_DATA_BIT;
-                memcpy(buf + 1 , data, leftover);
-                ret = i2c_write_blocking(oled->i2c, oled->addr, buf, leftover + 1, true);
-                if (ret != (leftover + 1))
-                        return -1;
-
-                sent += leftover;
-        }
-
-        return sent;
+        return len;
 }
+
+const rp2040_oled_transport_t rp2040_oled_i2c_transport = {
+        .init          = rp2040_i2c_init,
+        .test_addr     = rp2040_i2c_test_addr,
+        .read_register = rp2040_i2c_read_register,
+        .write         = rp2040_i2c_write,
+        .write_data    = rp2040_i2c_write_data,
+        .async_begin   = rp2040_i2c_async_begin,
+        .async_submit  = rp2040_i2c_async_submit,
+        .async_busy    = rp2040_oled_async_busy,
+        /* start + address + stop ~ 2 bytes, plus the control byte */
+        .txn_cost      = 3,
+};
@@ -0,0 +1,148 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Copyright 2023, Artem Savkov
+ */
+
+#ifndef _RP2040_OLED_INLINE_H
+#define _RP2040_OLED_INLINE_H
+
+#include <string.h>
+
+#include "rp2040-oled.h"
+
+/*
+ * Framebuffer and dirty tracking primitives shared by the C core and
+ * rp2040-oled.hpp, so both keep the same bookkeeping. Not part of the API.
+ */
+
+static inline void rp2040_oled_mark_dirty(rp2040_oled_t *oled, uint8_t page, uint8_t x,
+                                          size_t width)
+{
+        rp2040_oled_span_t *span = &oled->dirty_spans[page];
+        uint8_t x1 = x + width - 1;
+
+        if (!(oled->dirty_pages & 1u << page)) {
+                span->x0 = x;
+                span->x1 = x1;
+                oled->dirty_pages |= 1u << page;
+                return;
+        }
+
+        if (x < span->x0)
+                span->x0 = x;
+        if (x1 > span->x1)
+                span->x1 = x1;
+}
+
+/* Sets the dirty bitmap bits of columns [x0, x1] in one page row */
+static inline void rp2040_oled_set_dirty_bits(uint8_t *row, uint8_t x0, uint8_t x1)
+{
+        uint8_t b0 = x0 / 8;
+        uint8_t b1 = x1 / 8;
+        uint8_t m0 = 0xff << x0 % 8;
+        uint8_t m1 = 0xff >> (7 - x1 % 8);
+
+        if (b0 == b1) {
+                row[b0] |= m0 & m1;
+                return;
+        }
+
+        row[b0] |= m0;
+        memset(row + b0 + 1, 0xff, b1 - b0 - 1);
+        row[b1] |= m1;
+}
+
+/*
+ * Records that width columns from x of a page changed in the working buffer.
+ * dirty_bits is the single buffer mode bitmap, NULL with use_doublebuf. The
+ * layout comes in as arguments so callers that know it at compile time get
+ * it folded in.
+ */
+static inline void rp2040_oled_touch_strided(rp2040_oled_t *oled, uint8_t *dirty_bits,
+                                             size_t dirty_stride, uint8_t page, uint8_t x,
+                                             size_t width)
+{
+        if (width == 0)
+                return;
+
+        rp2040_oled_mark_dirty(oled, page, x, width);
+        if (dirty_bits)
+                rp2040_oled_set_dirty_bits(dirty_bits + page * dirty_stride, x, x + width - 1);
+
+        oled->is_dirty = true;
+}
+
+static inline void rp2040_oled_touch(rp2040_oled_t *oled, uint8_t page, uint8_t x,
+                                     size_t width)
+{
+        rp2040_oled_touch_strided(oled, oled->use_doublebuf ? NULL : oled->dirty_buf,
+                                  (oled->width + 7) / 8, page, x, width);
+}
+
+/*
+ * Colors a solid shape can be drawn with. The source of a shape is all ones,
+ * so AND_NOT clears like BLACK and INVERT flips like XOR. FULL_BYTE has no
+ * meaning for a shape.
+ */
+static inline bool rp2040_oled_shape_color(rp2040_oled_color_t color)
+{
+        return color == OLED_COLOR_WHITE || color == OLED_COLOR_BLACK ||
+               color == OLED_COLOR_XOR || color == OLED_COLOR_AND_NOT ||
+               color == OLED_COLOR_INVERT;
+}
+
+/*
+ * Fills columns [x0, x1] of rows [y0, y1] of the working buffer fb, pages
+ * stride bytes apart, page by page. The first and last page get a mask, pages
+ * fully inside are set with memset. Colors a shape cannot be drawn with leave
+ * the buffer alone. Dirty tracking as in rp2040_oled_touch_strided().
+ */
+static inline void rp2040_oled_fill_span_strided(rp2040_oled_t *oled, uint8_t *fb,
+                                                 size_t stride, uint8_t *dirty_bits,
+                                                 size_t dirty_stride, uint8_t x0, uint8_t x1,
+                                                 uint8_t y0, uint8_t y1,
+                                                 rp2040_oled_color_t color)
+{
+        uint8_t width = x1 - x0 + 1;
+
+        if (!rp2040_oled_shape_color(color))
+                return;
+
+        for (uint8_t page = y0 / PAGE_BITS; page <= y1 / PAGE_BITS; page++) {
+                uint8_t *dst = fb + page * stride + x0;
+                uint8_t mask = 0xff;
+
+                if (page == y0 / PAGE_BITS)
+                        mask &= 0xff << y0 % PAGE_BITS;
+                if (page == y1 / PAGE_BITS)
+                        mask &= 0xff >> (PAGE_BITS - 1 - y1 % PAGE_BITS);
+
+                if (color == OLED_COLOR_XOR || color == OLED_COLOR_INVERT) {
+                        for (uint8_t i = 0; i < width; i++)
+                                dst[i] ^= mask;
+                } else if (mask == 0xff) {
+                        memset(dst, color == OLED_COLOR_WHITE ? 0xff : 0x00, width);
+                } else if (color == OLED_COLOR_WHITE) {
+                        for (uint8_t i = 0; i < width; i++)
+                                dst[i] |= mask;
+                } else if (color == OLED_COLOR_BLACK || color == OLED_COLOR_AND_NOT) {
+                        for (uint8_t i = 0; i < width; i++)
+                                dst[i] &= ~mask;
+                }
+
+                rp2040_oled_touch_strided(oled, dirty_bits, dirty_stride, page, x0, width);
+        }
+}
+
+static inline void rp2040_oled_fill_span(rp2040_oled_t *oled, uint8_t x0, uint8_t x1,
+                                         uint8_t y0, uint8_t y1, rp2040_oled_color_t color)
+{
+        if (oled->use_doublebuf)
+                rp2040_oled_fill_span_strided(oled, oled->dirty_buf, oled->width, NULL, 0,
+                                              x0, x1, y0, y1, color);
+        else
+                rp2040_oled_fill_span_strided(oled, oled->gdram, oled->width, oled->dirty_buf,
+                                              (oled->width + 7) / 8, x0, x1, y0, y1, color);
+}
+
+#endif /* _RP2040_OLED_INLINE_H */
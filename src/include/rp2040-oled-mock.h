@@ -0,0 +1,76 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Copyright 2023, Artem Savkov
+ */
+
+#ifndef _RP2040_OLED_MOCK_H
+#define _RP2040_OLED_MOCK_H
+
+#include "rp2040-oled.h"
+
+#define RP2040_OLED_MOCK_COLUMNS 132
+#define RP2040_OLED_MOCK_PAGES   16
+
+/*
+ * Emulated controller sitting on the other end of the mock transport. Every
+ * write is parsed the way an SSD1306/SH1106/SH1107 would parse it, so ram[]
+ * holds what the panel would hold and the counters hold what the bus carried.
+ */
+typedef struct _rp2040_oled_mock {
+        rp2040_oled_type_t type;
+        uint8_t            addr;
+        uint8_t            status;
+        uint8_t            columns;
+        uint8_t            pages;
+
+        uint8_t            ram[RP2040_OLED_MOCK_PAGES][RP2040_OLED_MOCK_COLUMNS];
+        uint8_t            page;
+        uint8_t            column;
+        rp2040_oled_addr_mode_t addr_mode;
+        uint8_t            column_start;
+        uint8_t            column_end;
+        uint8_t            page_start;
+        uint8_t            page_end;
+        uint8_t            start_line;
+        uint8_t            contrast;
+        bool               power;
+        bool               inverse;
+        bool               scrolling;
+
+        /* gathered copy of the last write_data() transaction */
+        uint8_t            txn[1 + RP2040_OLED_MOCK_PAGES * RP2040_OLED_MOCK_COLUMNS];
+        /* one piece of a write split up by rp2040_oled_t.max_transfer */
+        uint8_t            piece[1 + RP2040_OLED_MOCK_PAGES * RP2040_OLED_MOCK_COLUMNS];
+
+        /* command currently being assembled from the byte stream */
+        uint8_t            cmd[8];
+        uint8_t            cmd_len;
+        uint8_t            cmd_need;
+
+        /* bus statistics */
+        size_t             transactions;
+        size_t             bytes;
+        size_t             cmd_bytes;
+        size_t             data_bytes;
+        size_t             reads;
+
+        /* optional hook invoked for every write transaction */
+        void (*on_transaction)(struct _rp2040_oled_mock *mock, const uint8_t *data,
+                               size_t len);
+        void *user_data;
+} rp2040_oled_mock_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern const rp2040_oled_transport_t rp2040_oled_mock_transport;
+
+void rp2040_oled_mock_init(rp2040_oled_mock_t *mock, rp2040_oled_type_t type);
+void rp2040_oled_mock_reset_stats(rp2040_oled_mock_t *mock);
+bool rp2040_oled_mock_verify(rp2040_oled_t *oled);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* _RP2040_OLED_MOCK_H */
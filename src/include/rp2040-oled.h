@@ -6,14 +6,81 @@
 #ifndef _RP2040_OLED_H
 #define _RP2040_OLED_H
 
+#ifdef RP2040_OLED_HOST
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct i2c_inst i2c_inst_t;
+typedef struct spi_inst spi_inst_t;
+#else
 #include "pico/stdlib.h"
 #include "hardware/i2c.h"
+#include "hardware/spi.h"
+#endif
 
 #define PIN_UNDEF 0xff
 
 #define GPIO_LEVEL_HIGH 1
 #define GPIO_LEVEL_LOW 0
 #define PAGE_BITS 8
+#define OLED_MAX_PAGES 16
+
+/*
+ * Geometry by size name, for sizing the buffers of the allocation-free mode
+ * at compile time, e.g. static uint8_t gdram[RP2040_OLED_GDRAM_SIZE(128x64)];
+ */
+#define RP2040_OLED_WIDTH_128x128  128
+#define RP2040_OLED_HEIGHT_128x128 128
+#define RP2040_OLED_WIDTH_128x64   128
+#define RP2040_OLED_HEIGHT_128x64  64
+#define RP2040_OLED_WIDTH_128x32   128
+#define RP2040_OLED_HEIGHT_128x32  32
+#define RP2040_OLED_WIDTH_132x64   132
+#define RP2040_OLED_HEIGHT_132x64  64
+#define RP2040_OLED_WIDTH_96x16    96
+#define RP2040_OLED_HEIGHT_96x16   16
+#define RP2040_OLED_WIDTH_64x128   64
+#define RP2040_OLED_HEIGHT_64x128  128
+#define RP2040_OLED_WIDTH_64x32    64
+#define RP2040_OLED_HEIGHT_64x32   32
+#define RP2040_OLED_WIDTH_72x40    72
+#define RP2040_OLED_HEIGHT_72x40   40
+
+#define RP2040_OLED_PAGES(size) (RP2040_OLED_HEIGHT_##size / PAGE_BITS)
+#define RP2040_OLED_GDRAM_SIZE(size) (RP2040_OLED_WIDTH_##size * RP2040_OLED_PAGES(size))
+/* a second frame with use_doublebuf, a bit per column and page otherwise */
+#define RP2040_OLED_DIRTY_BUF_SIZE(size, doublebuf)                                \
+        ((doublebuf) ? RP2040_OLED_GDRAM_SIZE(size) :                            \
+                       ((RP2040_OLED_WIDTH_##size + 7) / 8) * RP2040_OLED_PAGES(size))
+/* scratch for a full frame write on transports without write_data */
+#define RP2040_OLED_ARENA_SIZE(size) (RP2040_OLED_GDRAM_SIZE(size) + 1)
+/* pre-shifted copies of a sprite, see rp2040_oled_sprite_t */
+#define RP2040_OLED_SPRITE_SHIFTED_SIZE(width, height) \
+        ((PAGE_BITS - 1) * (width) * (((height) + PAGE_BITS - 1) / PAGE_BITS + 1))
+/*
+ * Async transfer queue, in uint16_t words: a full frame with addressing, plus
+ * a restart and control byte for every split when max_transfer (0 for none)
+ * splits transactions on I2C.
+ */
+#define RP2040_OLED_ASYNC_QUEUE_WORDS(words, max_transfer) \
+        ((words) + ((max_transfer) > 1 ? 2 * ((words) / ((max_transfer) - 1) + 1) : 0))
+#define RP2040_OLED_ASYNC_WORDS(size, max_transfer) \
+        RP2040_OLED_ASYNC_QUEUE_WORDS(RP2040_OLED_PAGES(size) * (RP2040_OLED_WIDTH_##size + 16), \
+                                      max_transfer)
+
+#ifndef RP2040_OLED_LAYOUT_LINES
+#define RP2040_OLED_LAYOUT_LINES 8
+#endif
+
+/* enough for the widest panel in the 6x8 font */
+#ifndef RP2040_OLED_CONSOLE_COLUMNS
+#define RP2040_OLED_CONSOLE_COLUMNS 22
+#endif
+
+#ifndef RP2040_OLED_GLYPH_CACHE_SLOTS
+#define RP2040_OLED_GLYPH_CACHE_SLOTS 16
+#endif
 
 enum {
         OLED_CB_CONTINUATION_BIT = 0x80,
@@ -35,8 +102,24 @@ typedef enum {
         OLED_COLOR_BLACK = 0,
         OLED_COLOR_WHITE,
         OLED_COLOR_FULL_BYTE,
+        /*
+         * Raster ops for sprites, text and filled rectangles: XOR flips the
+         * pixels set in the source, AND_NOT clears them and INVERT flips
+         * every pixel the source covers. Lines and rectangles flip their
+         * area for both XOR and INVERT and clear it for AND_NOT, they reject
+         * FULL_BYTE.
+         */
+        OLED_COLOR_XOR,
+        OLED_COLOR_AND_NOT,
+        OLED_COLOR_INVERT,
 } rp2040_oled_color_t;
 
+typedef enum {
+        OLED_ALIGN_LEFT = 0,
+        OLED_ALIGN_CENTER,
+        OLED_ALIGN_RIGHT,
+} rp2040_oled_align_t;
+
 typedef enum {
         OLED_NOT_FOUND = -1,
         OLED_SSD1306_3C,
@@ -53,6 +136,12 @@ typedef enum {
         OLED_CMD_SET_SSD1306_ADDR_MODE     = 0x20,
         OLED_CMD_SET_ADDR_PAGE             = 0x20,
         OLED_CMD_SET_ADDR_VERTICAL         = 0x21,
+        OLED_CMD_SET_SSD1306_COLUMN_RANGE  = 0x21,
+        OLED_CMD_SET_SSD1306_PAGE_RANGE    = 0x22,
+        OLED_CMD_SSD1306_SCROLL_RIGHT      = 0x26,
+        OLED_CMD_SSD1306_SCROLL_LEFT       = 0x27,
+        OLED_CMD_SSD1306_SCROLL_STOP       = 0x2e,
+        OLED_CMD_SSD1306_SCROLL_START      = 0x2f,
         OLED_CMD_SET_DISPLAY_STARTLINE0    = 0x40,
         OLED_CMD_SET_CONTRAST              = 0x81,
         OLED_CMD_SET_CHARGE_PUMP           = 0x8d,
@@ -79,6 +168,24 @@ typedef enum {
         OLED_CMD_RMW_END                   = 0xee,
 } rp2040_oled_cmd_t;
 
+typedef enum {
+        OLED_SSD1306_ADDR_HORIZONTAL = 0x00,
+        OLED_SSD1306_ADDR_VERTICAL   = 0x01,
+        OLED_SSD1306_ADDR_PAGE       = 0x02,
+} rp2040_oled_addr_mode_t;
+
+/* frames between two steps of horizontal scrolling, in SSD1306 encoding */
+typedef enum {
+        OLED_SCROLL_2_FRAMES   = 0x07,
+        OLED_SCROLL_3_FRAMES   = 0x04,
+        OLED_SCROLL_4_FRAMES   = 0x05,
+        OLED_SCROLL_5_FRAMES   = 0x00,
+        OLED_SCROLL_25_FRAMES  = 0x06,
+        OLED_SCROLL_64_FRAMES  = 0x01,
+        OLED_SCROLL_128_FRAMES = 0x02,
+        OLED_SCROLL_256_FRAMES = 0x03,
+} rp2040_oled_scroll_speed_t;
+
 typedef enum {
         FLIP_NONE       = 0x0,
         FLIP_HORIZONTAL = 0x1,
@@ -86,18 +193,208 @@ typedef enum {
         FLIP_BOTH       = (FLIP_HORIZONTAL | FLIP_VERTICAL)
 } rp2040_oled_flip_t;
 
+typedef struct {
+        uint8_t x;
+        uint8_t y;
+} rp2040_oled_point_t;
+
+typedef struct {
+        uint8_t x;
+        uint8_t y;
+        uint8_t width;
+        uint8_t height;
+} rp2040_oled_rect_t;
+
+typedef enum {
+        /* byte x of page p holds pixels (x, 8p) to (x, 8p + 7), LSB on top */
+        OLED_FB_PAGED_1BPP = 0,
+} rp2040_oled_fb_format_t;
+
+typedef struct {
+        uint8_t                 *data;
+        /* bytes from the start of one page to the next */
+        size_t                  stride;
+        uint8_t                 width;
+        uint8_t                 height;
+        rp2040_oled_fb_format_t format;
+} rp2040_oled_framebuffer_t;
+
+/* inclusive column range */
+typedef struct {
+        uint8_t x0;
+        uint8_t x1;
+} rp2040_oled_span_t;
+
+/*
+ * A glyph is stored as (height + 7) / 8 pages of width column bytes, top page
+ * first, bit 0 the top row. The bytes of a glyph are either stored as is or,
+ * in rle fonts, as packets: a header n < 0x80 is followed by n + 1 literal
+ * bytes, a header n >= 0x80 by one byte repeated (n & 0x7f) + 1 times.
+ */
+typedef struct {
+        /* of the first byte of the glyph in rp2040_oled_font_t.data */
+        uint32_t offset;
+        uint8_t  width;
+        uint8_t  height;
+        /* rows between the top of the line and the first stored row */
+        uint8_t  y_offset;
+        /* columns the pen moves right after the glyph */
+        uint8_t  advance;
+} rp2040_oled_glyph_t;
+
+/* Code points first to first + count - 1 map to glyphs from glyph on */
+typedef struct {
+        uint32_t first;
+        uint16_t count;
+        uint16_t glyph;
+} rp2040_oled_font_range_t;
+
+typedef struct {
+        const uint8_t                  *data;
+        const rp2040_oled_glyph_t      *glyphs;
+        /* sorted by first and not overlapping, looked up by binary search */
+        const rp2040_oled_font_range_t *ranges;
+        uint16_t                       range_count;
+        /* drawn for code points the font has no glyph for, 0 skips them */
+        uint32_t                       fallback;
+        /* line height */
+        uint8_t                        height;
+        bool                           rle;
+} rp2040_oled_font_t;
+
+/*
+ * Text wrapped into a rectangle by rp2040_oled_layout_text(), kept so it can
+ * be drawn again without measuring. It points into the text, which has to
+ * stay around unchanged.
+ */
+typedef struct {
+        const rp2040_oled_font_t *font;
+        const char               *msg;
+        rp2040_oled_rect_t       rect;
+        uint8_t                  line_count;
+        struct {
+                /* bytes of msg */
+                uint16_t start;
+                uint16_t len;
+                /* screen column the line starts at */
+                int16_t  x;
+        } lines[RP2040_OLED_LAYOUT_LINES];
+} rp2040_oled_layout_t;
+
+/*
+ * Log console of rp2040_oled_console_init(), a text line per page in the
+ * 6x8 font. text is a ring of what is on screen, top line in slot head.
+ */
+typedef struct {
+        struct _rp2040_oled *oled;
+        char    text[OLED_MAX_PAGES][RP2040_OLED_CONSOLE_COLUMNS];
+        uint8_t len[OLED_MAX_PAGES];
+        uint8_t head;
+        uint8_t count;
+} rp2040_oled_console_t;
+
+/*
+ * A page layout sprite (width bytes per page, bit 0 the top row, the
+ * rp2040_oled_draw_sprite() format) set up with rp2040_oled_sprite_init().
+ * shifted is optional: RP2040_OLED_SPRITE_SHIFTED_SIZE() bytes that get the
+ * sprite pre-shifted to every row within a page, so blits at any y are plain
+ * copies. A mask in the same layout, added with rp2040_oled_sprite_set_mask(),
+ * limits blits to the pixels set in it.
+ */
+typedef struct {
+        const uint8_t *data;
+        uint8_t       width;
+        uint8_t       height;
+        uint8_t       *shifted;
+        const uint8_t *mask;
+        uint8_t       *mask_shifted;
+} rp2040_oled_sprite_t;
+
+/*
+ * Glyphs of the 6x8 font shifted for text at one row within a page, so text
+ * that stays at the same y % PAGE_BITS does not shift every glyph every time.
+ * Direct-mapped by character, zero-initialise before first use.
+ */
+typedef struct {
+        uint8_t  shift;
+        /* character - 31 in each slot, 0 for empty */
+        uint8_t  glyphs[RP2040_OLED_GLYPH_CACHE_SLOTS];
+        uint16_t columns[RP2040_OLED_GLYPH_CACHE_SLOTS][5];
+} rp2040_oled_glyph_cache_t;
+
+struct _rp2040_oled;
+
+/* ok is false if the display did not take the whole frame */
+typedef void (*rp2040_oled_flush_cb_t)(struct _rp2040_oled *oled, bool ok, void *user_data);
+
+/*
+ * txn_cost is what starting a transaction costs on the wire in byte times
+ * (addressing, framing, control byte), flush uses it to decide when merging
+ * two dirty runs is cheaper than addressing them separately.
+ *
+ * write_data() sends rows of width bytes, stride bytes apart, as a single
+ * data transaction with the control byte supplied by the transport, so GDRAM
+ * can be sent in place. It returns the number of data bytes sent.
+ *
+ * async_begin/async_submit are optional. Between the two calls write() only
+ * queues transactions, async_submit() then sends the whole queue in the
+ * background and calls rp2040_oled_flush_complete() when done or aborted.
+ */
+typedef struct _rp2040_oled_transport {
+        void   (*init)(struct _rp2040_oled *oled);
+        bool   (*test_addr)(struct _rp2040_oled *oled, uint8_t addr);
+        int    (*read_register)(struct _rp2040_oled *oled, uint8_t reg, uint8_t *data,
+                                size_t len);
+        size_t (*write)(struct _rp2040_oled *oled, const uint8_t *data, size_t len);
+        size_t (*write_data)(struct _rp2040_oled *oled, const uint8_t *data, uint8_t width,
+                             uint8_t rows, size_t stride);
+        bool   (*async_begin)(struct _rp2040_oled *oled);
+        bool   (*async_submit)(struct _rp2040_oled *oled);
+        bool   (*async_busy)(struct _rp2040_oled *oled);
+        uint8_t txn_cost;
+} rp2040_oled_transport_t;
+
 typedef struct _rp2040_oled {
+        const rp2040_oled_transport_t *transport;
+        void               *transport_data;
         i2c_inst_t         *i2c;
         uint8_t            sda_pin;
         uint8_t            scl_pin;
+        spi_inst_t         *spi;
+        uint8_t            sck_pin;
+        uint8_t            mosi_pin;
+        uint8_t            cs_pin;
+        uint8_t            dc_pin;
         uint32_t           baudrate;
         uint8_t            addr;
+        /*
+         * I2C: longest transaction in bytes, control byte included, for bus
+         * bridges that cannot take more. 0 streams each write in one go.
+         */
+        uint16_t           max_transfer;
         uint8_t            reset_pin;
+        /* detected on I2C, has to be set up front for SPI */
+        rp2040_oled_type_t type;
         rp2040_oled_size_t size;
         uint8_t            width;
         uint8_t            height;
+        /* where the panel sits in display RAM, set by rp2040_oled_init() */
+        uint8_t            column_offset;
+        uint8_t            page_offset;
         bool               invert;
         rp2040_oled_flip_t flip;
+        /*
+         * Allocation-free mode: with an arena set nothing is taken from the
+         * heap. gdram and dirty_buf (and core1.mailbox/work for use_core1,
+         * async.buf/size for rp2040_oled_flush_async()) have to be filled in
+         * before rp2040_oled_init(), sized with the RP2040_OLED_*_SIZE()
+         * macros and 4-byte aligned for the word-wise diff, init fails
+         * otherwise. Transports that cannot gather take their bus buffer
+         * from it.
+         */
+        uint8_t            *arena;
+        size_t             arena_size;
+        size_t             arena_top;
         uint8_t            *gdram;
         size_t             gdram_size;
         struct {
@@ -107,22 +404,143 @@ typedef struct _rp2040_oled {
         uint8_t *dirty_buf;
         size_t  dirty_buf_size;
         bool    is_dirty;
+        /*
+         * Bit per page written to since the last flush, with the columns
+         * touched in each of those pages. Flush only looks inside the spans.
+         */
+        uint16_t dirty_pages;
+        rp2040_oled_span_t dirty_spans[OLED_MAX_PAGES];
         bool    use_doublebuf;
+        bool    fb_locked;
+        /* optional, used by rp2040_oled_write_string() at y not page aligned */
+        rp2040_oled_glyph_cache_t *glyph_cache;
+        /*
+         * SSD1306 only: use horizontal addressing so multi-page updates and
+         * full frames go out as a single window. Cleared on other controllers.
+         */
+        bool    use_horizontal_addr;
+        /*
+         * Hardware scrolling state: the RAM page the start line shows at the
+         * top, relative to where page 0 is at start line 0, and the pages a
+         * running horizontal scroll moves around.
+         */
+        uint8_t scroll_page;
+        struct {
+                bool    active;
+                uint8_t first;
+                uint8_t last;
+        } hscroll;
+        /*
+         * Hand the bus over to a worker on core1: rp2040_oled_flush() only
+         * publishes the frame and core1 sends it. Implies use_doublebuf and
+         * takes core1 and the inter-core FIFO for the library.
+         */
+        bool    use_core1;
+        struct {
+                uint8_t       *mailbox;
+                uint8_t       *work;
+                /* dirty_pages and dirty_spans of the frame in the mailbox */
+                uint16_t      pages;
+                rp2040_oled_span_t spans[OLED_MAX_PAGES];
+                volatile bool full;
+                volatile bool busy;
+        } core1;
+        struct {
+                uint16_t               *buf;
+                size_t                 size;
+                size_t                 len;
+                size_t                 pos;
+                int                    dma_chan;
+                bool                   recording;
+                bool                   overflow;
+                volatile bool          busy;
+                rp2040_oled_flush_cb_t callback;
+                void                   *user_data;
+        } async;
 } rp2040_oled_t;
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+#ifndef RP2040_OLED_HOST
+extern const rp2040_oled_transport_t rp2040_oled_i2c_transport;
+/* 4-wire SPI: dc_pin selects command/data, cs_pin may be PIN_UNDEF if tied low */
+extern const rp2040_oled_transport_t rp2040_oled_spi_transport;
+#endif
+
+/* proportional versions of the built-in 6x8 font, 8 and 16 rows high */
+extern const rp2040_oled_font_t rp2040_oled_font_8;
+extern const rp2040_oled_font_t rp2040_oled_font_16;
+
 rp2040_oled_type_t rp2040_oled_init(rp2040_oled_t *oled);
 bool rp2040_oled_clear(rp2040_oled_t *oled);
 bool rp2040_oled_clear_gdram(rp2040_oled_t *oled);
 bool rp2040_oled_set_contrast(rp2040_oled_t *oled, uint8_t contrast);
 bool rp2040_oled_set_power(rp2040_oled_t *oled, bool enabled);
+/*
+ * Draws len bytes of UTF-8 text with the top of the line at y. Set glyph pixels
+ * are drawn in color (white, black or xor), the rest is left alone. Glyphs are
+ * decoded straight into the framebuffer and clipped at every edge.
+ */
+bool rp2040_oled_draw_text(rp2040_oled_t *oled, const rp2040_oled_font_t *font, int16_t x,
+                           int16_t y, const char *msg, size_t len, rp2040_oled_color_t color,
+                           bool render);
+/* columns from the start of the text to the right edge of its last glyph */
+uint16_t rp2040_oled_text_width(const rp2040_oled_font_t *font, const char *msg, size_t len);
+/*
+ * Word-wraps text into rect, breaking at spaces and newlines, and aligns each
+ * line. Words wider than rect are split. Returns false if the text needs more
+ * lines than fit, the layout then holds the ones that do.
+ */
+bool rp2040_oled_layout_text(rp2040_oled_layout_t *layout, const rp2040_oled_font_t *font,
+                             const rp2040_oled_rect_t *rect, const char *msg, size_t len,
+                             rp2040_oled_align_t align);
+/* Draws a layout like rp2040_oled_draw_text(), clipped to its rectangle */
+bool rp2040_oled_draw_layout(rp2040_oled_t *oled, const rp2040_oled_layout_t *layout,
+                             rp2040_oled_color_t color, bool render);
+/* any y, glyphs are ORed in and clipped at the right and bottom edges */
 bool rp2040_oled_write_string(rp2040_oled_t *oled, uint8_t x, uint8_t y, char *msg,
                               size_t len, bool render);
 bool rp2040_oled_set_pixel(rp2040_oled_t *oled, uint8_t x, uint8_t y,
                            rp2040_oled_color_t color, bool render);
+/*
+ * Plots many pixels at once straight into the framebuffer, skipping points
+ * that are off screen. Dirty tracking is updated once per page touched
+ * instead of once per pixel.
+ */
+bool rp2040_oled_set_pixels(rp2040_oled_t *oled, const rp2040_oled_point_t *points,
+                            size_t count, rp2040_oled_color_t color, bool render);
+/*
+ * Same for the set bits of a packed 1bpp bitmap placed at x, y: rows are
+ * pitch bytes apart, MSB is the leftmost pixel (the draw_sprite_pitched()
+ * layout). Clear bits leave the framebuffer as it is.
+ */
+bool rp2040_oled_set_pixels_bitmap(rp2040_oled_t *oled, int16_t x, int16_t y,
+                                   const uint8_t *bitmap, uint8_t width, uint8_t height,
+                                   uint8_t pitch, rp2040_oled_color_t color, bool render);
+/* data has to stay around, shifted may be NULL */
+void rp2040_oled_sprite_init(rp2040_oled_sprite_t *sprite, const uint8_t *data, uint8_t width,
+                             uint8_t height, uint8_t *shifted);
+/* mask and shifted work like data and shifted of rp2040_oled_sprite_init() */
+void rp2040_oled_sprite_set_mask(rp2040_oled_sprite_t *sprite, const uint8_t *mask,
+                                 uint8_t *shifted);
+/*
+ * Converts a draw_sprite_pitched() bitmap to the paged layout of
+ * rp2040_oled_draw_sprite() into dst (width * pages bytes), eight columns at a
+ * time. Bitmaps drawn often can be converted once and kept for sprite_init().
+ */
+void rp2040_oled_sprite_convert(uint8_t *dst, const uint8_t *src, uint8_t width,
+                                uint8_t height, uint8_t pitch);
+/*
+ * Draws a prepared sprite at any position, clipped to the screen: white ORs
+ * its set bits in, black ANDs it in, full byte copies it, the rest are the
+ * raster ops of rp2040_oled_color_t. Only the rows and columns the sprite (or
+ * its mask) covers are changed, so a full byte blit of a masked sprite draws
+ * it with transparency.
+ */
+bool rp2040_oled_blit_sprite(rp2040_oled_t *oled, const rp2040_oled_sprite_t *sprite, int16_t x,
+                             int16_t y, rp2040_oled_color_t color, bool render);
 bool rp2040_oled_draw_sprite(rp2040_oled_t *oled, const uint8_t *sprite, int16_t x,
                              int16_t y, uint8_t width, uint8_t height,
                              rp2040_oled_color_t color, bool render);
@@ -138,7 +556,68 @@ bool rp2040_oled_draw_circle(rp2040_oled_t *oled, int16_t x, int16_t y, uint8_t
 bool rp2040_oled_draw_ellipse(rp2040_oled_t *oled, int16_t x, int16_t y, uint8_t rx,
                               uint8_t ry, rp2040_oled_color_t color, bool fill,
                               bool render);
+/* r is clamped to half the shorter side */
+bool rp2040_oled_draw_rounded_rectangle(rp2040_oled_t *oled, uint8_t x0, uint8_t y0,
+                                        uint8_t x1, uint8_t y1, uint8_t r,
+                                        rp2040_oled_color_t color, bool fill, bool render);
+/*
+ * Outline of the part of an ellipse from angle start to angle end, in
+ * degrees. 0 points right and angles grow clockwise, as y grows downwards.
+ */
+bool rp2040_oled_draw_arc(rp2040_oled_t *oled, int16_t x, int16_t y, uint8_t rx, uint8_t ry,
+                          int16_t start, int16_t end, rp2040_oled_color_t color, bool render);
+/*
+ * Hands out the buffer drawing functions write to, for drawing into it
+ * directly. Changes are only picked up by flush once rp2040_oled_unlock()
+ * marks them dirty: pass the rectangle that was drawn to, or NULL for the
+ * whole screen (with use_doublebuf flush then diffs out what changed).
+ * While locked the drawing functions still draw, but nothing is sent: flushes,
+ * render = true included, are held back until a flush after the unlock, and
+ * the scroll functions that start a scroll fail.
+ */
+bool rp2040_oled_lock_framebuffer(rp2040_oled_t *oled, rp2040_oled_framebuffer_t *fb);
+bool rp2040_oled_unlock(rp2040_oled_t *oled, const rp2040_oled_rect_t *rect);
 bool rp2040_oled_flush(rp2040_oled_t *oled);
+/*
+ * Queues the same transfers rp2040_oled_flush() would make and returns while
+ * they are still being sent. callback (may be NULL) is called once the
+ * transfer is done, possibly from interrupt context. Drawing may continue in
+ * the meantime, anything that needs the bus waits for the transfer to finish.
+ * Falls back to a blocking flush if the transport has no async support, or
+ * if not even a full frame fits the queue.
+ */
+bool rp2040_oled_flush_async(rp2040_oled_t *oled, rp2040_oled_flush_cb_t callback,
+                             void *user_data);
+bool rp2040_oled_flush_busy(rp2040_oled_t *oled);
+/*
+ * Moves the picture up by pages (down if negative) with the display start
+ * line, a single command. The framebuffer and dirty state move along, so
+ * everything drawn keeps its place relative to the screen, and the pages
+ * scrolled in are cleared: they are all the next flush has to send.
+ * Not available while a horizontal scroll is running.
+ */
+bool rp2040_oled_scroll_vertical(rp2040_oled_t *oled, int8_t pages, bool render);
+/*
+ * SSD1306 only: starts moving pages first to last around horizontally by one
+ * column every speed frames, after flushing what is pending. The controller
+ * rotates its RAM while it scrolls, rp2040_oled_scroll_stop() puts the
+ * framebuffer contents of those pages back.
+ */
+bool rp2040_oled_scroll_horizontal(rp2040_oled_t *oled, uint8_t first, uint8_t last,
+                                   bool left, rp2040_oled_scroll_speed_t speed);
+bool rp2040_oled_scroll_stop(rp2040_oled_t *oled, bool render);
+/*
+ * Starts an empty console on oled, it takes the whole screen. Lines fill it
+ * from the top, once it is full each new line scrolls the panel up a page
+ * with rp2040_oled_scroll_vertical() and is drawn into the page that scrolls
+ * in, so an append costs one command and one page of data.
+ */
+void rp2040_oled_console_init(rp2040_oled_console_t *console, rp2040_oled_t *oled);
+/* Appends msg, a line per '\n', lines too long for the screen wrap */
+bool rp2040_oled_console_write(rp2040_oled_console_t *console, const char *msg, size_t len,
+                               bool render);
+/* Draws every line again, e.g. after something else drew over the console */
+bool rp2040_oled_console_redraw(rp2040_oled_console_t *console, bool render);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,265 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Copyright 2023, Artem Savkov
+ */
+
+#ifndef _RP2040_OLED_HPP
+#define _RP2040_OLED_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "rp2040-oled.h"
+#include "rp2040-oled-inline.h"
+#ifdef RP2040_OLED_HOST
+#include "rp2040-oled-mock.h"
+#endif
+
+/* relaxed constexpr for the geometry switches */
+static_assert(__cplusplus >= 201402L, "rp2040-oled.hpp needs C++14");
+
+/*
+ * Header-only C++ front end. Oled<> fixes panel size, controller and bus at
+ * compile time: geometry and buffer sizes are constants, the buffers
+ * are members (the C core runs in its allocation-free mode on them) and the
+ * pixel/rect primitives below inline the fill and dirty tracking of the core
+ * with constant page and dirty bitmap strides.
+ * The rest of the C API is available on handle().
+ */
+namespace rp2040_oled {
+
+enum class Controller {
+        SSD1306,
+        SH1106,
+        SH1107,
+};
+
+constexpr uint8_t width(rp2040_oled_size_t size)
+{
+        switch (size) {
+                case OLED_128x128:
+                case OLED_128x64:
+                case OLED_128x32:
+                        return 128;
+                case OLED_132x64:
+                        return 132;
+                case OLED_96x16:
+                        return 96;
+                case OLED_64x128:
+                case OLED_64x32:
+                        return 64;
+                case OLED_72x40:
+                        return 72;
+        }
+        return 0;
+}
+
+constexpr uint8_t height(rp2040_oled_size_t size)
+{
+        switch (size) {
+                case OLED_128x128:
+                case OLED_64x128:
+                        return 128;
+                case OLED_128x64:
+                case OLED_132x64:
+                        return 64;
+                case OLED_128x32:
+                case OLED_64x32:
+                        return 32;
+                case OLED_96x16:
+                        return 16;
+                case OLED_72x40:
+                        return 40;
+        }
+        return 0;
+}
+
+#ifndef RP2040_OLED_HOST
+struct I2c {
+        i2c_inst_t *i2c;
+        uint8_t    sda_pin;
+        uint8_t    scl_pin;
+        uint32_t   baudrate;
+        /* 0 scans for the display */
+        uint8_t    addr = 0x00;
+        uint8_t    reset_pin = PIN_UNDEF;
+
+        void apply(rp2040_oled_t &oled) const
+        {
+                oled.transport = &rp2040_oled_i2c_transport;
+                oled.i2c = i2c;
+                oled.sda_pin = sda_pin;
+                oled.scl_pin = scl_pin;
+                oled.baudrate = baudrate;
+                oled.addr = addr;
+                oled.reset_pin = reset_pin;
+        }
+};
+
+struct Spi {
+        spi_inst_t *spi;
+        uint8_t    sck_pin;
+        uint8_t    mosi_pin;
+        uint8_t    dc_pin;
+        uint8_t    cs_pin = PIN_UNDEF;
+        uint32_t   baudrate;
+        uint8_t    reset_pin = PIN_UNDEF;
+
+        void apply(rp2040_oled_t &oled) const
+        {
+                oled.transport = &rp2040_oled_spi_transport;
+                oled.spi = spi;
+                oled.sck_pin = sck_pin;
+                oled.mosi_pin = mosi_pin;
+                oled.dc_pin = dc_pin;
+                oled.cs_pin = cs_pin;
+                oled.baudrate = baudrate;
+                oled.reset_pin = reset_pin;
+        }
+};
+#else
+struct Mock {
+        rp2040_oled_mock_t *mock;
+
+        void apply(rp2040_oled_t &oled) const
+        {
+                oled.transport = &rp2040_oled_mock_transport;
+                oled.transport_data = mock;
+                oled.addr = mock->addr;
+        }
+};
+#endif
+
+template <rp2040_oled_size_t Size, Controller Ctrl, typename Transport,
+          bool DoubleBuf = false, rp2040_oled_flip_t Flip = FLIP_NONE>
+class Oled {
+public:
+        static constexpr uint8_t width = rp2040_oled::width(Size);
+        static constexpr uint8_t height = rp2040_oled::height(Size);
+        static constexpr uint8_t pages = height / PAGE_BITS;
+        static constexpr size_t stride = width;
+        static constexpr size_t gdram_size = stride * pages;
+        static constexpr size_t dirty_stride = (width + 7) / 8;
+        static constexpr size_t dirty_buf_size = DoubleBuf ? gdram_size : dirty_stride * pages;
+        static constexpr size_t arena_size = gdram_size + 1;
+
+        static_assert(width != 0 && height != 0, "unknown panel size");
+        static_assert(pages <= OLED_MAX_PAGES, "too many pages for dirty tracking");
+        static_assert(height <= 64 || Ctrl == Controller::SH1107,
+                      "only the SH1107 drives more than 64 rows");
+
+        explicit Oled(const Transport &transport) : transport_(transport) {}
+
+        /* the C core keeps pointers into the object */
+        Oled(const Oled &) = delete;
+        Oled &operator=(const Oled &) = delete;
+
+        /*
+         * Fields of handle() other than bus, geometry and buffers may be set
+         * up front (e.g. use_horizontal_addr). Fails if nothing answers or a
+         * different controller is detected.
+         */
+        bool init()
+        {
+                rp2040_oled_type_t type;
+
+                transport_.apply(oled_);
+                oled_.size = Size;
+                oled_.flip = Flip;
+                oled_.type = controller_type(oled_.addr);
+                oled_.use_doublebuf = DoubleBuf;
+                oled_.use_core1 = false;
+                oled_.gdram = gdram_.data();
+                oled_.dirty_buf = dirty_.data();
+                oled_.arena = arena_.data();
+                oled_.arena_size = arena_.size();
+
+                type = rp2040_oled_init(&oled_);
+                if (type == OLED_NOT_FOUND)
+                        return false;
+
+                return type == controller_type(oled_.addr);
+        }
+
+        rp2040_oled_t *handle() { return &oled_; }
+
+        /* paged 1bpp, byte x of page p at [p * stride + x] */
+        uint8_t *framebuffer() { return DoubleBuf ? dirty_.data() : gdram_.data(); }
+
+        template <uint8_t X, uint8_t Y>
+        void pixel(rp2040_oled_color_t color)
+        {
+                static_assert(X < width && Y < height, "pixel off screen");
+                plot(X, Y, color);
+        }
+
+        void pixel(uint8_t x, uint8_t y, rp2040_oled_color_t color)
+        {
+                if (x < width && y < height)
+                        plot(x, y, color);
+        }
+
+        template <uint8_t X, uint8_t Y, uint8_t W, uint8_t H>
+        void fill_rect(rp2040_oled_color_t color)
+        {
+                static_assert(W > 0 && H > 0, "empty rectangle");
+                static_assert(X + W <= width && Y + H <= height, "rectangle off screen");
+                fill(X, X + W - 1, Y, Y + H - 1, color);
+        }
+
+        /* clipped to the screen */
+        void fill_rect(int16_t x, int16_t y, int16_t w, int16_t h, rp2040_oled_color_t color)
+        {
+                int16_t x1 = x + w - 1;
+                int16_t y1 = y + h - 1;
+
+                if (x < 0)
+                        x = 0;
+                if (y < 0)
+                        y = 0;
+                if (x1 >= width)
+                        x1 = width - 1;
+                if (y1 >= height)
+                        y1 = height - 1;
+
+                if (w > 0 && h > 0 && x <= x1 && y <= y1)
+                        fill(x, x1, y, y1, color);
+        }
+
+        bool clear() { return rp2040_oled_clear(&oled_); }
+        bool flush() { return rp2040_oled_flush(&oled_); }
+
+private:
+        static constexpr rp2040_oled_type_t controller_type(uint8_t addr)
+        {
+                int type = Ctrl == Controller::SSD1306 ? OLED_SSD1306_3C :
+                           Ctrl == Controller::SH1106  ? OLED_SH1106_3C :
+                                                         OLED_SH1107_3C;
+
+                return static_cast<rp2040_oled_type_t>(type + (addr == 0x3d));
+        }
+
+        /* the fill of the C core with this panel's layout as constants */
+        void plot(uint8_t x, uint8_t y, rp2040_oled_color_t color)
+        {
+                fill(x, x, y, y, color);
+        }
+
+        void fill(uint8_t x0, uint8_t x1, uint8_t y0, uint8_t y1, rp2040_oled_color_t color)
+        {
+                rp2040_oled_fill_span_strided(&oled_, framebuffer(), stride,
+                                              DoubleBuf ? nullptr : dirty_.data(),
+                                              dirty_stride, x0, x1, y0, y1, color);
+        }
+
+        Transport                                  transport_;
+        rp2040_oled_t                              oled_{};
+        alignas(4) std::array<uint8_t, gdram_size> gdram_{};
+        alignas(4) std::array<uint8_t, dirty_buf_size> dirty_{};
+        std::array<uint8_t, arena_size>            arena_{};
+};
+
+} /* namespace rp2040_oled */
+
+#endif /* _RP2040_OLED_HPP */
@@ -0,0 +1,360 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Copyright 2023, Artem Savkov
+ */
+
+#include <string.h>
+
+#include "include/rp2040-oled-mock.h"
+#include "gfx.h"
+
+typedef enum {
+        MOCK_SSD1306,
+        MOCK_SH1106,
+        MOCK_SH1107,
+} rp2040_oled_mock_family_t;
+
+/*
+ * Where each panel the controllers get paired with sits in their RAM, taken
+ * from the module wiring rather than from gfx.c so that the verification
+ * does not just repeat the library's own idea of it.
+ */
+typedef struct {
+        rp2040_oled_mock_family_t family;
+        rp2040_oled_size_t        size;
+        uint8_t                   column;
+        uint8_t                   page;
+        uint8_t                   flipped_column;
+        uint8_t                   flipped_page;
+} rp2040_oled_mock_panel_t;
+
+static const rp2040_oled_mock_panel_t rp2040_oled_mock_panels[] = {
+        { MOCK_SSD1306, OLED_128x64,   0, 0,  0, 0 },
+        { MOCK_SSD1306, OLED_128x32,   0, 0,  0, 0 },
+        { MOCK_SSD1306, OLED_96x16,    0, 2, 32, 0 },
+        { MOCK_SSD1306, OLED_72x40,   28, 3, 28, 0 },
+        { MOCK_SSD1306, OLED_64x32,   32, 4, 32, 0 },
+        { MOCK_SH1106,  OLED_128x64,   0, 0,  0, 0 },
+        { MOCK_SH1106,  OLED_132x64,   2, 0,  2, 0 },
+        { MOCK_SH1107,  OLED_128x128,  0, 0,  0, 0 },
+        { MOCK_SH1107,  OLED_64x128,   0, 0,  0, 0 },
+};
+
+static rp2040_oled_mock_family_t rp2040_oled_mock_family(rp2040_oled_mock_t *mock)
+{
+        switch (mock->type) {
+                case OLED_SH1106_3C:
+                case OLED_SH1106_3D:
+                        return MOCK_SH1106;
+                case OLED_SH1107_3C:
+                case OLED_SH1107_3D:
+                        return MOCK_SH1107;
+                default:
+                        return MOCK_SSD1306;
+        }
+}
+
+static bool rp2040_oled_mock_is_ssd1306(rp2040_oled_mock_t *mock)
+{
+        return rp2040_oled_mock_family(mock) == MOCK_SSD1306;
+}
+
+static const rp2040_oled_mock_panel_t *rp2040_oled_mock_panel(rp2040_oled_mock_t *mock,
+                                                              rp2040_oled_size_t size)
+{
+        rp2040_oled_mock_family_t family = rp2040_oled_mock_family(mock);
+
+        for (size_t i = 0; i < sizeof(rp2040_oled_mock_panels) /
+                               sizeof(rp2040_oled_mock_panels[0]); i++) {
+                if (rp2040_oled_mock_panels[i].family == family &&
+                    rp2040_oled_mock_panels[i].size == size)
+                        return &rp2040_oled_mock_panels[i];
+        }
+
+        return NULL;
+}
+
+static uint8_t rp2040_oled_mock_cmd_args(rp2040_oled_mock_t *mock, uint8_t cmd)
+{
+        switch (cmd) {
+                case OLED_CMD_SET_SSD1306_ADDR_MODE:
+                        return rp2040_oled_mock_is_ssd1306(mock) ? 1 : 0;
+                case OLED_CMD_SET_SSD1306_COLUMN_RANGE:
+                case OLED_CMD_SET_SSD1306_PAGE_RANGE:
+                        return rp2040_oled_mock_is_ssd1306(mock) ? 2 : 0;
+                case OLED_CMD_SSD1306_SCROLL_RIGHT:
+                case OLED_CMD_SSD1306_SCROLL_LEFT:
+                        return 6;
+                case 0x29:
+                case 0x2a:
+                        return 5;
+                case 0xa3:
+                        return 2;
+                case OLED_CMD_SET_CONTRAST:
+                case OLED_CMD_SET_CHARGE_PUMP:
+                case OLED_CMD_SET_MULTIPLEX_RATIO:
+                case OLED_CMD_SET_DC_DC:
+                case OLED_CMD_SET_DISPLAY_OFFSET:
+                case OLED_CMD_SET_DISPLAY_CLOCK:
+                case 0xd6:
+                case OLED_CMD_SET_PRECHARGE_PERIOD:
+                case OLED_CMD_SET_COM_PINS:
+                case OLED_CMD_SET_VCOM_DESELECT_LEVEL:
+                case OLED_CMD_SET_DISPLAY_STARTLINE:
+                        return 1;
+                default:
+                        return 0;
+        }
+}
+
+static void rp2040_oled_mock_exec(rp2040_oled_mock_t *mock)
+{
+        uint8_t cmd = mock->cmd[0];
+        bool ssd1306 = rp2040_oled_mock_is_ssd1306(mock);
+
+        if (cmd < OLED_CMD_SET_HC_ADDR) {
+                mock->column = (mock->column & 0xf0) | (cmd & 0x0f);
+        } else if (cmd < OLED_CMD_SET_SSD1306_ADDR_MODE) {
+                mock->column = (mock->column & 0x0f) | ((cmd & 0x0f) << 4);
+        } else if (cmd >= OLED_CMD_SET_DISPLAY_STARTLINE0 && cmd < 0x80) {
+                mock->start_line = cmd & 0x3f;
+        } else if (cmd >= OLED_CMD_SET_PAGE_ADDR && cmd < OLED_CMD_SET_SCAN_DIR_NORMAL) {
+                mock->page = cmd & 0x0f;
+        } else if (cmd == OLED_CMD_SET_SSD1306_ADDR_MODE && ssd1306) {
+                mock->addr_mode = mock->cmd[1] & 0x03;
+        } else if (cmd == OLED_CMD_SET_SSD1306_COLUMN_RANGE && ssd1306) {
+                mock->column_start = mock->cmd[1];
+                mock->column_end = mock->cmd[2];
+                mock->column = mock->column_start;
+        } else if (cmd == OLED_CMD_SET_SSD1306_PAGE_RANGE && ssd1306) {
+                mock->page_start = mock->cmd[1];
+                mock->page_end = mock->cmd[2];
+                mock->page = mock->page_start;
+        } else if (cmd == OLED_CMD_SSD1306_SCROLL_STOP) {
+                mock->scrolling = false;
+        } else if (cmd == OLED_CMD_SSD1306_SCROLL_START) {
+                mock->scrolling = true;
+        } else if (cmd == OLED_CMD_SET_CONTRAST) {
+                mock->contrast = mock->cmd[1];
+        } else if (cmd == OLED_CMD_SET_DISPLAY_NORMAL || cmd == OLED_CMD_SET_DISPLAY_INVERSE) {
+                mock->inverse = cmd == OLED_CMD_SET_DISPLAY_INVERSE;
+        } else if (cmd == OLED_CMD_DISPLAY_OFF || cmd == OLED_CMD_DISPLAY_ON) {
+                mock->power = cmd == OLED_CMD_DISPLAY_ON;
+        } else if (cmd == OLED_CMD_SET_DISPLAY_STARTLINE) {
+                mock->start_line = mock->cmd[1];
+        }
+}
+
+static void rp2040_oled_mock_write_cmd(rp2040_oled_mock_t *mock, uint8_t byte)
+{
+        mock->cmd_bytes++;
+
+        if (mock->cmd_len == 0)
+                mock->cmd_need = rp2040_oled_mock_cmd_args(mock, byte);
+        else
+                mock->cmd_need--;
+
+        mock->cmd[mock->cmd_len++] = byte;
+        if (mock->cmd_need == 0) {
+                rp2040_oled_mock_exec(mock);
+                mock->cmd_len = 0;
+        }
+}
+
+static void rp2040_oled_mock_write_ram(rp2040_oled_mock_t *mock, uint8_t byte)
+{
+        mock->data_bytes++;
+
+        /* the column counter wraps within the RAM, 132x64 runs past its end */
+        if (mock->addr_mode == OLED_SSD1306_ADDR_PAGE)
+                mock->column %= mock->columns;
+
+        if (mock->page < mock->pages && mock->column < mock->columns)
+                mock->ram[mock->page][mock->column] = byte;
+
+        switch (mock->addr_mode) {
+                case OLED_SSD1306_ADDR_PAGE:
+                        if (++mock->column >= mock->columns)
+                                mock->column = 0;
+                        break;
+                case OLED_SSD1306_ADDR_HORIZONTAL:
+                        if (mock->column++ >= mock->column_end) {
+                                mock->column = mock->column_start;
+                                if (mock->page++ >= mock->page_end)
+                                        mock->page = mock->page_start;
+                        }
+                        break;
+                case OLED_SSD1306_ADDR_VERTICAL:
+                        if (mock->page++ >= mock->page_end) {
+                                mock->page = mock->page_start;
+                                if (mock->column++ >= mock->column_end)
+                                        mock->column = mock->column_start;
+                        }
+                        break;
+        }
+}
+
+static bool rp2040_oled_mock_test_addr(rp2040_oled_t *oled, uint8_t addr)
+{
+        rp2040_oled_mock_t *mock = oled->transport_data;
+
+        return addr == mock->addr;
+}
+
+static int rp2040_oled_mock_read_register(rp2040_oled_t *oled, uint8_t reg, uint8_t *data,
+                                          size_t len)
+{
+        rp2040_oled_mock_t *mock = oled->transport_data;
+
+        mock->reads++;
+        memset(data, 0x00, len);
+        if (len > 0)
+                data[0] = mock->status;
+
+        return len;
+}
+
+static void rp2040_oled_mock_transaction(rp2040_oled_mock_t *mock, const uint8_t *data,
+                                         size_t len)
+{
+        size_t i = 0;
+
+        mock->transactions++;
+        mock->bytes += len;
+
+        if (mock->on_transaction)
+                mock->on_transaction(mock, data, len);
+
+        while (i < len) {
+                uint8_t control = data[i++];
+                size_t count = len - i;
+
+                if ((control & OLED_CB_CONTINUATION_BIT) && count > 1)
+                        count = 1;
+
+                for (; count > 0; count--, i++) {
+                        if (control & OLED_CB_DATA_BIT)
+                                rp2040_oled_mock_write_ram(mock, data[i]);
+                        else
+                                rp2040_oled_mock_write_cmd(mock, data[i]);
+                }
+        }
+}
+
+static size_t rp2040_oled_mock_write(rp2040_oled_t *oled, const uint8_t *data, size_t len)
+{
+        rp2040_oled_mock_t *mock = oled->transport_data;
+        size_t chunk = oled->max_transfer;
+
+        if (chunk < 2 || len <= chunk || chunk > sizeof(mock->piece)) {
+                rp2040_oled_mock_transaction(mock, data, len);
+                return len;
+        }
+
+        /* split the way the I2C transport does, repeating the control byte */
+        mock->piece[0] = data[0];
+        for (size_t sent = 1; sent < len; sent += chunk - 1) {
+                size_t count = len - sent < chunk - 1 ? len - sent : chunk - 1;
+
+                memcpy(mock->piece + 1, data + sent, count);
+                rp2040_oled_mock_transaction(mock, mock->piece, count + 1);
+        }
+
+        return len;
+}
+
+static size_t rp2040_oled_mock_write_data(rp2040_oled_t *oled, const uint8_t *data,
+                                          uint8_t width, uint8_t rows, size_t stride)
+{
+        rp2040_oled_mock_t *mock = oled->transport_data;
+        size_t size = width * rows;
+
+        if (size + 1 > sizeof(mock->txn))
+                return 0;
+
+        mock->txn[0] = OLED_CB_DATA_BIT;
+        for (uint8_t row = 0; row < rows; row++)
+                memcpy(mock->txn + 1 + row * width, data + row * stride, width);
+
+        return rp2040_oled_mock_write(oled, mock->txn, size + 1) - 1;
+}
+
+const rp2040_oled_transport_t rp2040_oled_mock_transport = {
+        .test_addr     = rp2040_oled_mock_test_addr,
+        .read_register = rp2040_oled_mock_read_register,
+        .write         = rp2040_oled_mock_write,
+        .write_data    = rp2040_oled_mock_write_data,
+        /* costed like the I2C bus it stands in for */
+        .txn_cost      = 3,
+};
+
+void rp2040_oled_mock_init(rp2040_oled_mock_t *mock, rp2040_oled_type_t type)
+{
+        memset(mock, 0x00, sizeof(*mock));
+
+        mock->type = type;
+        mock->addr = (type == OLED_SSD1306_3D || type == OLED_SH1106_3D ||
+                      type == OLED_SH1107_3D) ? 0x3d : 0x3c;
+
+        switch (type) {
+                case OLED_SH1106_3C:
+                case OLED_SH1106_3D:
+                        mock->status = 0x08;
+                        mock->columns = 132;
+                        mock->pages = 8;
+                        break;
+                case OLED_SH1107_3C:
+                case OLED_SH1107_3D:
+                        mock->status = 0x07;
+                        mock->columns = 128;
+                        mock->pages = 16;
+                        break;
+                default:
+                        mock->status = 0x06;
+                        mock->columns = 128;
+                        mock->pages = 8;
+                        break;
+        }
+
+        mock->addr_mode = OLED_SSD1306_ADDR_PAGE;
+        mock->column_end = mock->columns - 1;
+        mock->page_end = mock->pages - 1;
+        mock->contrast = 0x7f;
+}
+
+void rp2040_oled_mock_reset_stats(rp2040_oled_mock_t *mock)
+{
+        mock->transactions = 0;
+        mock->bytes = 0;
+        mock->cmd_bytes = 0;
+        mock->data_bytes = 0;
+        mock->reads = 0;
+}
+
+bool rp2040_oled_mock_verify(rp2040_oled_t *oled)
+{
+        rp2040_oled_mock_t *mock = oled->transport_data;
+        const rp2040_oled_mock_panel_t *panel = rp2040_oled_mock_panel(mock, oled->size);
+        uint8_t xoff, poff;
+
+        if (!panel)
+                return false;
+
+        xoff = oled->flip == FLIP_NONE ? panel->column : panel->flipped_column;
+        poff = oled->flip == FLIP_NONE ? panel->page : panel->flipped_page;
+
+        if (oled->width > mock->columns || oled->height / PAGE_BITS + poff > mock->pages)
+                return false;
+
+        for (uint8_t page = 0; page < oled->height / PAGE_BITS; page++) {
+                uint8_t ram_page = (page + poff + mock->start_line / PAGE_BITS) % mock->pages;
+
+                for (uint8_t x = 0; x < oled->width; x++) {
+                        if (mock->ram[ram_page][(x + xoff) % mock->columns] !=
+                            oled->gdram[page * oled->width + x])
+                                return false;
+                }
+        }
+
+        return true;
+}
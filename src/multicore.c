@@ -0,0 +1,113 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Copyright 2023, Artem Savkov
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "pico/multicore.h"
+
+#include "multicore.h"
+#include "gfx.h"
+
+/*
+ * core0 draws into dirty_buf and publishes complete frames into the mailbox.
+ * core1 swaps the mailbox with its work buffer, diffs the work buffer against
+ * gdram (the copy of what the panel shows) and sends the differences. core0
+ * only has to wait if a frame is still in the mailbox, i.e. if it is more
+ * than one frame ahead of the panel.
+ */
+static void rp2040_oled_core1_entry(void)
+{
+        while (true) {
+                rp2040_oled_t *oled = (rp2040_oled_t *)(uintptr_t)multicore_fifo_pop_blocking();
+                uint8_t *frame = oled->core1.mailbox;
+                uint16_t pages = oled->core1.pages;
+                rp2040_oled_span_t spans[OLED_MAX_PAGES];
+
+                /* the mailbox side is free for the next frame once full drops */
+                memcpy(spans, oled->core1.spans, sizeof(spans));
+
+                oled->core1.mailbox = oled->core1.work;
+                oled->core1.work = frame;
+                oled->core1.busy = true;
+                __dmb();
+                oled->core1.full = false;
+
+                rp2040_oled_flush_diff(oled, frame, pages, spans);
+
+                __dmb();
+                oled->core1.busy = false;
+                rp2040_oled_flush_complete(oled, true);
+        }
+}
+
+bool rp2040_oled_core1_init(rp2040_oled_t *oled)
+{
+        static bool launched = false;
+
+        /* allocation-free mode brings its own buffers, or goes without core1 */
+        if (!oled->arena) {
+                oled->core1.mailbox = malloc(oled->gdram_size);
+                oled->core1.work = malloc(oled->gdram_size);
+        }
+
+        /* flushed against gdram a word at a time, same alignment needed */
+        if (!oled->core1.mailbox || !oled->core1.work ||
+            (((uintptr_t)oled->core1.mailbox | (uintptr_t)oled->core1.work) & 3)) {
+                if (!oled->arena) {
+                        free(oled->core1.mailbox);
+                        free(oled->core1.work);
+                }
+                return false;
+        }
+
+        oled->core1.full = false;
+        oled->core1.busy = false;
+
+        /* one worker serves every display, the FIFO tells it which one */
+        if (!launched) {
+                multicore_launch_core1(rp2040_oled_core1_entry);
+                launched = true;
+        }
+
+        return true;
+}
+
+bool rp2040_oled_core1_publish(rp2040_oled_t *oled)
+{
+        if (!oled->is_dirty)
+                return true;
+
+        while (oled->core1.full)
+                tight_loop_contents();
+        __dmb();
+
+        memcpy(oled->core1.mailbox, oled->dirty_buf, oled->gdram_size);
+        oled->core1.pages = oled->dirty_pages;
+        memcpy(oled->core1.spans, oled->dirty_spans, sizeof(oled->core1.spans));
+        oled->is_dirty = false;
+        oled->dirty_pages = 0;
+
+        __dmb();
+        oled->core1.full = true;
+        multicore_fifo_push_blocking((uint32_t)(uintptr_t)oled);
+
+        return true;
+}
+
+bool rp2040_oled_core1_busy(rp2040_oled_t *oled)
+{
+        if (oled->core1.full)
+                return true;
+        __dmb();
+
+        return oled->core1.busy;
+}
+
+void rp2040_oled_core1_wait(rp2040_oled_t *oled)
+{
+        while (rp2040_oled_core1_busy(oled))
+                tight_loop_contents();
+}
@@ -0,0 +1,11 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Copyright 2023, Artem Savkov
+ */
+
+#include "include/rp2040-oled.h"
+
+bool rp2040_oled_core1_init(rp2040_oled_t *oled);
+bool rp2040_oled_core1_publish(rp2040_oled_t *oled);
+bool rp2040_oled_core1_busy(rp2040_oled_t *oled);
+void rp2040_oled_core1_wait(rp2040_oled_t *oled);
@@ -7,21 +7,23 @@
 #include <string.h>
 
 #include "gfx.h"
-#include "i2c.h"
+#include "multicore.h"
+#include "transport.h"
 #include "display.h"
 
 static bool rp2040_oled_write_command(rp2040_oled_t *oled, uint8_t cmd)
 {
         uint8_t buf[] = { 0x00, cmd };
-        return rp2040_i2c_write(oled, buf, sizeof(buf)) == sizeof(buf);
+        return rp2040_oled_bus_write(oled, buf, sizeof(buf)) == sizeof(buf);
 }
 
 static bool rp2040_oled_write_command_with_arg(rp2040_oled_t *oled, uint8_t cmd, uint8_t arg)
 {
         uint8_t buf[] = { 0x00, cmd, arg };
-        return rp2040_i2c_write(oled, buf, sizeof(buf)) == sizeof(buf);
+        return rp2040_oled_bus_write(oled, buf, sizeof(buf)) == sizeof(buf);
 }
 
+#ifndef RP2040_OLED_HOST
 static void rp2040_oled_reset(rp2040_oled_t *oled)
 {
         gpio_put(oled->reset_pin, GPIO_LEVEL_LOW);
@@ -29,6 +31,7 @@ static void rp2040_oled_reset(rp2040_oled_t *oled)
         gpio_put(oled->reset_pin, GPIO_LEVEL_HIGH);
         sleep_ms(10);
 }
+#endif
 
 static int rp2040_oled_display_init(rp2040_oled_t *oled)
 {
@@ -88,7 +91,10 @@ static int rp2040_oled_display_init(rp2040_oled_t *oled)
                         return -1;
         };
 
-        rp2040_i2c_write(oled, initbuf, initlen);
+        /* size and flip are final here, autodetect may have turned an SH1107 */
+        rp2040_oled_get_offset(oled, &oled->column_offset, &oled->page_offset);
+
+        rp2040_oled_bus_write(oled, initbuf, initlen);
 
         if (oled->invert)
                 rp2040_oled_write_command(oled, OLED_CMD_SET_DISPLAY_INVERSE);
@@ -98,20 +104,41 @@ static int rp2040_oled_display_init(rp2040_oled_t *oled)
         else if (oled->flip & FLIP_VERTICAL)
                 rp2040_oled_write_command(oled, OLED_CMD_SET_SCAN_DIR_NORMAL);
 
+        if (oled->type != OLED_SSD1306_3C && oled->type != OLED_SSD1306_3D)
+                oled->use_horizontal_addr = false;
+
+        if (oled->use_horizontal_addr)
+                rp2040_oled_write_command_with_arg(oled, OLED_CMD_SET_SSD1306_ADDR_MODE,
+                                                   OLED_SSD1306_ADDR_HORIZONTAL);
+
         oled->gdram_size = oled->width * oled->height / PAGE_BITS;
-        oled->gdram = malloc(oled->gdram_size);
-        memset(oled->gdram, 0x00, oled->gdram_size);
 
         if (oled->use_doublebuf) {
                 oled->dirty_buf_size = oled->gdram_size;
         } else {
-                oled->dirty_buf_size = (oled->width / 8) * (oled->height / PAGE_BITS);
+                oled->dirty_buf_size = ((oled->width + 7) / 8) * (oled->height / PAGE_BITS);
         }
 
-        rp2040_oled_force_flush(oled);
+        /* in allocation-free mode the caller has set both up already */
+        if (!oled->arena) {
+                oled->gdram = malloc(oled->gdram_size);
+                oled->dirty_buf = malloc(oled->dirty_buf_size);
+        }
 
-        oled->dirty_buf = malloc(oled->dirty_buf_size);
+        if (!oled->gdram || !oled->dirty_buf)
+                return -1;
+
+        /* the diff compares words, caller buffers could be off */
+        if (((uintptr_t)oled->gdram | (uintptr_t)oled->dirty_buf) & 3)
+                return -1;
+
+        memset(oled->gdram, 0x00, oled->gdram_size);
         memset(oled->dirty_buf, 0x00, oled->dirty_buf_size);
+        oled->arena_top = 0;
+        oled->scroll_page = 0;
+        oled->hscroll.active = false;
+
+        rp2040_oled_force_flush(oled);
 
         return 0;
 }
@@ -123,7 +150,7 @@ static uint8_t rp2040_oled_scan(rp2040_oled_t *oled)
 
         for (i = 0; i < sizeof(scan_addrs); i++) {
                 addr = scan_addrs[i];
-                if (rp2040_i2c_test_addr(oled, addr))
+                if (rp2040_oled_bus_test_addr(oled, addr))
                         return addr;
         }
 
@@ -142,7 +169,7 @@ bool rp2040_oled_is_sh1106(rp2040_oled_t *oled)
                 buf[0] = OLED_CB_CONTINUATION_BIT;
                 buf[1] = OLED_CMD_RMW_START;
                 buf[2] = 0xc0;
-                if (rp2040_i2c_write(oled, buf, 3) != 3)
+                if (rp2040_oled_bus_write(oled, buf, 3) != 3)
                         break;
 
                 if (i > 0 && buf[1] != TEST_DATA[i - 1])
@@ -153,7 +180,7 @@ bool rp2040_oled_is_sh1106(rp2040_oled_t *oled)
                 buf[2] = OLED_CB_CONTINUATION_BIT;
                 buf[3] = OLED_CMD_RMW_END;
 
-                if (rp2040_i2c_write(oled, buf, 4) != 4)
+                if (rp2040_oled_bus_write(oled, buf, 4) != 4)
                         break;
         }
 
@@ -167,7 +194,7 @@ rp2040_oled_type_t rp2040_oled_autodetect(rp2040_oled_t *oled)
         rp2040_oled_type_t type = OLED_NOT_FOUND;
         uint8_t status = 0x00;
 
-        if (rp2040_i2c_read_register(oled, 0x00, &status, 1) < 0)
+        if (rp2040_oled_bus_read_register(oled, 0x00, &status, 1) < 0)
                 return OLED_NOT_FOUND;
 
         status &= 0x0f;
@@ -194,24 +221,55 @@ rp2040_oled_type_t rp2040_oled_autodetect(rp2040_oled_t *oled)
 rp2040_oled_type_t rp2040_oled_init(rp2040_oled_t *oled)
 {
         rp2040_oled_type_t type = OLED_NOT_FOUND;
-        rp2040_i2c_init(oled);
 
+        if (!oled->transport) {
+#ifdef RP2040_OLED_HOST
+                return OLED_NOT_FOUND;
+#else
+                oled->transport = &rp2040_oled_i2c_transport;
+#endif
+        }
+
+        if (oled->transport->init)
+                oled->transport->init(oled);
+
+#ifndef RP2040_OLED_HOST
         if (oled->reset_pin != PIN_UNDEF) {
                 gpio_set_dir(oled->reset_pin, GPIO_OUT);
                 rp2040_oled_reset(oled);
         }
-
-        if (oled->addr == PIN_UNDEF || oled->addr == 0x00) {
-                oled->addr = rp2040_oled_scan(oled);
-                if (oled->addr == PIN_UNDEF)
+#endif
+
+        if (oled->transport->test_addr) {
+                if (oled->addr == PIN_UNDEF || oled->addr == 0x00) {
+                        oled->addr = rp2040_oled_scan(oled);
+                        if (oled->addr == PIN_UNDEF)
+                                return OLED_NOT_FOUND;
+                } else if (!rp2040_oled_bus_test_addr(oled, oled->addr)) {
                         return OLED_NOT_FOUND;
-        } else if (!rp2040_i2c_test_addr(oled, oled->addr)) {
-                return OLED_NOT_FOUND;
+                }
         }
 
-        type = rp2040_oled_autodetect(oled);
+        /* write-only buses can't detect the controller, trust the caller */
+        if (oled->transport->read_register)
+                oled->type = rp2040_oled_autodetect(oled);
+
+        type = oled->type;
+
+#ifdef RP2040_OLED_HOST
+        oled->use_core1 = false;
+#else
+        if (oled->use_core1)
+                oled->use_doublebuf = true;
+#endif
+
+        if (rp2040_oled_display_init(oled) < 0)
+                return OLED_NOT_FOUND;
 
-        rp2040_oled_display_init(oled);
+#ifndef RP2040_OLED_HOST
+        if (oled->use_core1 && !rp2040_oled_core1_init(oled))
+                oled->use_core1 = false;
+#endif
 
         return type;
 }
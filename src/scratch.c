@@ -0,0 +1,47 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Copyright 2023, Artem Savkov
+ */
+
+#include <stdlib.h>
+
+#include "scratch.h"
+
+/*
+ * Temporary buffers for a single drawing call. With an arena on the handle
+ * they are taken off the top of it like a stack and nothing is allocated,
+ * otherwise they come from the heap. Freeing a buffer releases everything
+ * taken after it too, so the order buffers are freed in does not matter.
+ */
+void *rp2040_oled_scratch_alloc(rp2040_oled_t *oled, size_t size)
+{
+        void *buf;
+
+        if (!oled->arena)
+                return malloc(size);
+
+        if (size > oled->arena_size - oled->arena_top)
+                return NULL;
+
+        buf = oled->arena + oled->arena_top;
+        oled->arena_top += size;
+
+        return buf;
+}
+
+void rp2040_oled_scratch_free(rp2040_oled_t *oled, void *buf)
+{
+        size_t offset;
+
+        if (!oled->arena) {
+                free(buf);
+                return;
+        }
+
+        if (!buf)
+                return;
+
+        offset = (uint8_t *)buf - oled->arena;
+        if (offset < oled->arena_top)
+                oled->arena_top = offset;
+}
@@ -0,0 +1,9 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Copyright 2023, Artem Savkov
+ */
+
+#include "include/rp2040-oled.h"
+
+void *rp2040_oled_scratch_alloc(rp2040_oled_t *oled, size_t size);
+void rp2040_oled_scratch_free(rp2040_oled_t *oled, void *buf);
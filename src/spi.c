@@ -0,0 +1,320 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Copyright 2023, Artem Savkov
+ */
+
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+
+#include "spi.h"
+#include "gfx.h"
+#include "async.h"
+
+/* shorter transfers are cheaper to push from the cpu than to set up dma for */
+#define SPI_DMA_MIN_LEN 16
+
+/* queued words carry the D/C level above the byte, the SPI only sends 8 bits */
+#define SPI_WORD_DC 0x100
+
+static rp2040_oled_t *rp2040_spi_dma_oled[NUM_DMA_CHANNELS];
+/* display whose queue is on the bus, per SPI block */
+static rp2040_oled_t *rp2040_spi_irq_oled[NUM_SPIS];
+
+static void rp2040_spi_select(rp2040_oled_t *oled, bool selected)
+{
+        if (oled->cs_pin != PIN_UNDEF)
+                gpio_put(oled->cs_pin, selected ? GPIO_LEVEL_LOW : GPIO_LEVEL_HIGH);
+}
+
+/* nobody reads what comes back while dma is feeding the fifo */
+static void rp2040_spi_drain_rx(rp2040_oled_t *oled)
+{
+        spi_hw_t *hw = spi_get_hw(oled->spi);
+
+        while (spi_is_readable(oled->spi))
+                (void)hw->dr;
+        hw->icr = SPI_SSPICR_RORIC_BITS | SPI_SSPICR_RTIC_BITS;
+}
+
+static void rp2040_spi_wait_idle(rp2040_oled_t *oled)
+{
+        while (spi_is_busy(oled->spi))
+                tight_loop_contents();
+
+        rp2040_spi_drain_rx(oled);
+}
+
+/* Sends queued words up to the next D/C change, returns false when done */
+static bool rp2040_spi_async_next(rp2040_oled_t *oled)
+{
+        dma_channel_config cfg;
+        size_t start = oled->async.pos;
+        uint16_t dc;
+
+        if (start >= oled->async.len)
+                return false;
+
+        dc = oled->async.buf[start] & SPI_WORD_DC;
+        while (oled->async.pos < oled->async.len &&
+               (oled->async.buf[oled->async.pos] & SPI_WORD_DC) == dc)
+                oled->async.pos++;
+
+        gpio_put(oled->dc_pin, dc ? GPIO_LEVEL_HIGH : GPIO_LEVEL_LOW);
+        /* the receive timeout ending this segment needs its own bytes only */
+        rp2040_spi_drain_rx(oled);
+
+        cfg = dma_channel_get_default_config(oled->async.dma_chan);
+        channel_config_set_transfer_data_size(&cfg, DMA_SIZE_16);
+        channel_config_set_read_increment(&cfg, true);
+        channel_config_set_write_increment(&cfg, false);
+        channel_config_set_dreq(&cfg, spi_get_dreq(oled->spi, true));
+
+        dma_channel_configure(oled->async.dma_chan, &cfg, &spi_get_hw(oled->spi)->dr,
+                              oled->async.buf + start, oled->async.pos - start, true);
+
+        return true;
+}
+
+static void rp2040_spi_dma_irq_handler(void)
+{
+        for (uint i = 0; i < NUM_DMA_CHANNELS; i++) {
+                rp2040_oled_t *oled = rp2040_spi_dma_oled[i];
+
+                if (!oled || !dma_channel_get_irq0_status(i))
+                        continue;
+
+                dma_channel_acknowledge_irq0(i);
+                if (!oled->async.busy)
+                        continue;
+
+                /*
+                 * D/C may only change once the last byte is out. The receive
+                 * timeout goes off 32 bit times after the last byte came back
+                 * with nothing read, the bus is idle by then.
+                 */
+                spi_get_hw(oled->spi)->imsc = SPI_SSPIMSC_RTIM_BITS;
+        }
+}
+
+static void rp2040_spi_irq_handler(void)
+{
+        for (uint i = 0; i < NUM_SPIS; i++) {
+                rp2040_oled_t *oled = rp2040_spi_irq_oled[i];
+                spi_hw_t *hw;
+
+                if (!oled)
+                        continue;
+
+                hw = spi_get_hw(oled->spi);
+                if (!(hw->mis & SPI_SSPMIS_RTMIS_BITS))
+                        continue;
+
+                hw->imsc = 0;
+                if (rp2040_spi_async_next(oled))
+                        continue;
+
+                rp2040_spi_drain_rx(oled);
+                rp2040_spi_select(oled, false);
+                rp2040_spi_irq_oled[i] = NULL;
+                oled->async.busy = false;
+                rp2040_oled_flush_complete(oled, true);
+        }
+}
+
+/* Claimed on first use, displays that only send short writes never need it */
+static void rp2040_spi_claim_dma(rp2040_oled_t *oled)
+{
+        static bool irq_installed = false;
+
+        rp2040_oled_async_claim_dma(oled, rp2040_spi_dma_oled, rp2040_spi_dma_irq_handler,
+                                    &irq_installed);
+}
+
+static void rp2040_spi_send(rp2040_oled_t *oled, const uint8_t *data, size_t len)
+{
+        dma_channel_config cfg;
+
+        if (len < SPI_DMA_MIN_LEN) {
+                spi_write_blocking(oled->spi, data, len);
+                return;
+        }
+
+        rp2040_spi_claim_dma(oled);
+
+        cfg = dma_channel_get_default_config(oled->async.dma_chan);
+        channel_config_set_transfer_data_size(&cfg, DMA_SIZE_8);
+        channel_config_set_read_increment(&cfg, true);
+        channel_config_set_write_increment(&cfg, false);
+        channel_config_set_dreq(&cfg, spi_get_dreq(oled->spi, true));
+
+        dma_channel_configure(oled->async.dma_chan, &cfg, &spi_get_hw(oled->spi)->dr, data,
+                              len, true);
+        dma_channel_wait_for_finish_blocking(oled->async.dma_chan);
+        rp2040_spi_wait_idle(oled);
+}
+
+static bool rp2040_spi_async_begin(rp2040_oled_t *oled)
+{
+        static bool spi_irq_installed[NUM_SPIS];
+        uint spi_index = spi_get_index(oled->spi);
+
+        /* every byte is its own FIFO entry, nothing is split */
+        if (!rp2040_oled_async_prepare(oled, 0))
+                return false;
+
+        rp2040_spi_claim_dma(oled);
+
+        if (!spi_irq_installed[spi_index]) {
+                irq_add_shared_handler(SPI0_IRQ + spi_index, rp2040_spi_irq_handler,
+                                       PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+                irq_set_enabled(SPI0_IRQ + spi_index, true);
+                spi_irq_installed[spi_index] = true;
+        }
+
+        rp2040_oled_async_record(oled);
+
+        return true;
+}
+
+static size_t rp2040_spi_async_write(rp2040_oled_t *oled, const uint8_t *data, size_t len)
+{
+        size_t i = 0;
+
+        while (i < len) {
+                uint8_t control = data[i++];
+                size_t count = len - i;
+
+                if ((control & OLED_CB_CONTINUATION_BIT) && count > 1)
+                        count = 1;
+
+                if (oled->async.len + count > oled->async.size) {
+                        oled->async.overflow = true;
+                        return 0;
+                }
+
+                for (; count > 0; count--, i++)
+                        oled->async.buf[oled->async.len++] = data[i] |
+                                (control & OLED_CB_DATA_BIT ? SPI_WORD_DC : 0);
+        }
+
+        return len;
+}
+
+static bool rp2040_spi_async_submit(rp2040_oled_t *oled)
+{
+        oled->async.recording = false;
+
+        if (oled->async.overflow)
+                return false;
+
+        if (oled->async.len == 0) {
+                rp2040_oled_flush_complete(oled, true);
+                return true;
+        }
+
+        rp2040_spi_irq_oled[spi_get_index(oled->spi)] = oled;
+        oled->async.pos = 0;
+        oled->async.busy = true;
+
+        rp2040_spi_select(oled, true);
+        rp2040_spi_async_next(oled);
+
+        return true;
+}
+
+void rp2040_spi_init(rp2040_oled_t *oled)
+{
+        spi_init(oled->spi, oled->baudrate);
+        spi_set_format(oled->spi, 8, SPI_CPOL_0, SPI_CPHA_0, SPI_MSB_FIRST);
+
+        gpio_set_function(oled->sck_pin, GPIO_FUNC_SPI);
+        gpio_set_function(oled->mosi_pin, GPIO_FUNC_SPI);
+
+        gpio_init(oled->dc_pin);
+        gpio_set_dir(oled->dc_pin, GPIO_OUT);
+        gpio_put(oled->dc_pin, GPIO_LEVEL_LOW);
+
+        if (oled->cs_pin != PIN_UNDEF) {
+                gpio_init(oled->cs_pin);
+                gpio_set_dir(oled->cs_pin, GPIO_OUT);
+                gpio_put(oled->cs_pin, GPIO_LEVEL_HIGH);
+        }
+
+        /* claimed on the first transfer long enough for dma */
+        oled->async.dma_chan = -1;
+}
+
+/*
+ * Takes the same control byte framing as the I2C transport and turns the
+ * control bytes into D/C levels.
+ */
+size_t rp2040_spi_write(rp2040_oled_t *oled, const uint8_t *data, size_t len)
+{
+        size_t i = 0;
+
+        if (oled->async.recording)
+                return rp2040_spi_async_write(oled, data, len);
+
+        rp2040_oled_async_wait(oled);
+
+        rp2040_spi_select(oled, true);
+        while (i < len) {
+                uint8_t control = data[i++];
+                size_t count = len - i;
+
+                if ((control & OLED_CB_CONTINUATION_BIT) && count > 1)
+                        count = 1;
+
+                gpio_put(oled->dc_pin, (control & OLED_CB_DATA_BIT) ? GPIO_LEVEL_HIGH : GPIO_LEVEL_LOW);
+                rp2040_spi_send(oled, data + i, count);
+                i += count;
+        }
+        rp2040_spi_select(oled, false);
+
+        return len;
+}
+
+static size_t rp2040_spi_write_data(rp2040_oled_t *oled, const uint8_t *data, uint8_t width,
+                                    uint8_t rows, size_t stride)
+{
+        size_t size = width * rows;
+
+        if (oled->async.recording) {
+                if (oled->async.len + size > oled->async.size) {
+                        oled->async.overflow = true;
+                        return 0;
+                }
+
+                for (uint8_t row = 0; row < rows; row++)
+                        for (uint8_t col = 0; col < width; col++)
+                                oled->async.buf[oled->async.len++] = data[row * stride + col] |
+                                                                     SPI_WORD_DC;
+
+                return size;
+        }
+
+        rp2040_oled_async_wait(oled);
+
+        rp2040_spi_select(oled, true);
+        gpio_put(oled->dc_pin, GPIO_LEVEL_HIGH);
+        if (stride == width) {
+                rp2040_spi_send(oled, data, size);
+        } else {
+                for (uint8_t row = 0; row < rows; row++)
+                        rp2040_spi_send(oled, data + row * stride, width);
+        }
+        rp2040_spi_select(oled, false);
+
+        return size;
+}
+
+const rp2040_oled_transport_t rp2040_oled_spi_transport = {
+        .init          = rp2040_spi_init,
+        .write         = rp2040_spi_write,
+        .write_data    = rp2040_spi_write_data,
+        .async_begin   = rp2040_spi_async_begin,
+        .async_submit  = rp2040_spi_async_submit,
+        .async_busy    = rp2040_oled_async_busy,
+        /* no control byte on the wire, just CS/DC turnaround */
+        .txn_cost      = 1,
+};
@@ -0,0 +1,79 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Copyright 2023, Artem Savkov
+ */
+
+#ifndef _RP2040_OLED_TRANSPORT_H
+#define _RP2040_OLED_TRANSPORT_H
+
+#include <string.h>
+
+#include "include/rp2040-oled.h"
+#include "multicore.h"
+#include "scratch.h"
+
+static inline void rp2040_oled_bus_claim(rp2040_oled_t *oled)
+{
+#ifndef RP2040_OLED_HOST
+        /* core1 owns the bus while it is sending a frame */
+        if (oled->use_core1 && get_core_num() == 0)
+                rp2040_oled_core1_wait(oled);
+#endif
+}
+
+static inline bool rp2040_oled_bus_test_addr(rp2040_oled_t *oled, uint8_t addr)
+{
+        if (!oled->transport->test_addr)
+                return true;
+
+        rp2040_oled_bus_claim(oled);
+
+        return oled->transport->test_addr(oled, addr);
+}
+
+static inline int rp2040_oled_bus_read_register(rp2040_oled_t *oled, uint8_t reg,
+                                                uint8_t *data, size_t len)
+{
+        if (!oled->transport->read_register)
+                return -1;
+
+        rp2040_oled_bus_claim(oled);
+
+        return oled->transport->read_register(oled, reg, data, len);
+}
+
+static inline size_t rp2040_oled_bus_write(rp2040_oled_t *oled, const uint8_t *data, size_t len)
+{
+        rp2040_oled_bus_claim(oled);
+
+        return oled->transport->write(oled, data, len);
+}
+
+static inline size_t rp2040_oled_bus_write_data(rp2040_oled_t *oled, const uint8_t *data,
+                                                uint8_t width, uint8_t rows, size_t stride)
+{
+        uint8_t *buf;
+        size_t size = width * rows;
+        size_t ret;
+
+        rp2040_oled_bus_claim(oled);
+
+        if (oled->transport->write_data)
+                return oled->transport->write_data(oled, data, width, rows, stride);
+
+        /* transports that can't gather get a contiguous copy */
+        buf = rp2040_oled_scratch_alloc(oled, size + 1);
+        if (!buf)
+                return 0;
+
+        buf[0] = OLED_CB_DATA_BIT;
+        for (uint8_t row = 0; row < rows; row++)
+                memcpy(buf + 1 + row * width, data + row * stride, width);
+
+        ret = oled->transport->write(oled, buf, size + 1);
+        rp2040_oled_scratch_free(oled, buf);
+
+        return ret == size + 1 ? size : 0;
+}
+
+#endif /* _RP2040_OLED_TRANSPORT_H */
@@ -0,0 +1,469 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Copyright 2023, Artem Savkov
+ */
+
+/*
+ * Draws the same scenes on every panel size and flush mode through the mock
+ * transport. After each flush the emulated GDRAM has to match the library's
+ * copy, and the bus counters of the whole run are printed for comparison.
+ * A few dirty patterns with a known cost also check the counters exactly.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "rp2040-oled.h"
+#include "rp2040-oled-mock.h"
+
+typedef struct {
+        rp2040_oled_type_t type;
+        rp2040_oled_size_t size;
+        const char         *name;
+} bench_panel_t;
+
+typedef struct {
+        bool     use_doublebuf;
+        bool     use_horizontal_addr;
+        uint16_t max_transfer;
+        bool     use_arena;
+} bench_mode_t;
+
+static const bench_panel_t panels[] = {
+        { OLED_SSD1306_3C, OLED_128x64,  "ssd1306 128x64" },
+        { OLED_SSD1306_3D, OLED_128x32,  "ssd1306 128x32" },
+        { OLED_SSD1306_3C, OLED_96x16,   "ssd1306 96x16" },
+        { OLED_SSD1306_3C, OLED_72x40,   "ssd1306 72x40" },
+        { OLED_SSD1306_3C, OLED_64x32,   "ssd1306 64x32" },
+        { OLED_SH1106_3C,  OLED_128x64,  "sh1106 128x64" },
+        { OLED_SH1106_3C,  OLED_132x64,  "sh1106 132x64" },
+        { OLED_SH1107_3C,  OLED_128x128, "sh1107 128x128" },
+};
+
+static const bench_mode_t modes[] = {
+        { false, false, 0,  false },
+        { true,  false, 0,  false },
+        { false, true,  0,  false },
+        { true,  true,  0,  false },
+        { false, false, 32, false },
+        { true,  true,  32, false },
+        { false, false, 0,  true },
+        { true,  true,  0,  true },
+};
+
+static const uint8_t smiley[] = {
+        0x3c, 0x42, 0xa5, 0x81, 0xa5, 0x99, 0x42, 0x3c,
+};
+
+static const uint8_t smiley_mask[] = {
+        0x3c, 0x7e, 0xff, 0xff, 0xff, 0xff, 0x7e, 0x3c,
+};
+
+/* buffers of the allocation-free modes, big enough for every panel */
+static uint8_t arena_gdram[RP2040_OLED_GDRAM_SIZE(128x128)] __attribute__((aligned(4)));
+static uint8_t arena_dirty[RP2040_OLED_DIRTY_BUF_SIZE(128x128, true)]
+        __attribute__((aligned(4)));
+static uint8_t arena[RP2040_OLED_ARENA_SIZE(128x128)];
+
+/* GDRAM kept to compare a later flush against */
+static uint8_t snapshot[RP2040_OLED_GDRAM_SIZE(128x128)];
+
+static int failures;
+
+static void bench_check(bool ok, const char *scene)
+{
+        if (!ok) {
+                printf("  %s: failed\n", scene);
+                failures++;
+        }
+}
+
+static bool bench_blank(rp2040_oled_t *oled)
+{
+        for (size_t i = 0; i < oled->gdram_size; i++) {
+                if (oled->gdram[i])
+                        return false;
+        }
+
+        return true;
+}
+
+static bool bench_flush(rp2040_oled_t *oled, const char *scene)
+{
+        if (!rp2040_oled_flush(oled) || !rp2040_oled_mock_verify(oled)) {
+                printf("  %s: GDRAM mismatch\n", scene);
+                failures++;
+                return false;
+        }
+
+        return true;
+}
+
+/* Transactions a write of len bytes after the control byte is split into */
+static size_t bench_pieces(const rp2040_oled_t *oled, size_t len)
+{
+        size_t chunk = oled->max_transfer;
+
+        if (chunk < 2 || len + 1 <= chunk)
+                return 1;
+
+        return (len + chunk - 2) / (chunk - 1);
+}
+
+/* Flushes and checks the bus carried runs data runs of width by pages each */
+static void bench_expect(rp2040_oled_t *oled, const char *scene, size_t runs, size_t width,
+                         size_t pages)
+{
+        rp2040_oled_mock_t *mock = oled->transport_data;
+        size_t position = oled->use_horizontal_addr ? 7 : 4;
+        size_t pieces = bench_pieces(oled, width * pages);
+        size_t transactions = runs * (1 + pieces);
+        size_t bytes = runs * (position + width * pages + pieces);
+
+        rp2040_oled_mock_reset_stats(mock);
+        if (!bench_flush(oled, scene))
+                return;
+
+        if (mock->transactions != transactions || mock->bytes != bytes) {
+                printf("  %s: %zu transactions %zu bytes, expected %zu and %zu\n", scene,
+                       mock->transactions, mock->bytes, transactions, bytes);
+                failures++;
+        }
+}
+
+static void bench_counts(rp2040_oled_t *oled)
+{
+        uint8_t w = oled->width;
+        uint8_t h = oled->height;
+
+        rp2040_oled_set_pixel(oled, 10, 0, OLED_COLOR_WHITE, false);
+        bench_expect(oled, "one byte", 1, 1, 1);
+
+        /* a clean gap within the cost of a transaction is sent along */
+        rp2040_oled_set_pixel(oled, 20, 0, OLED_COLOR_WHITE, false);
+        rp2040_oled_set_pixel(oled, 25, 0, OLED_COLOR_WHITE, false);
+        bench_expect(oled, "close runs", 1, 6, 1);
+
+        rp2040_oled_set_pixel(oled, 30, 0, OLED_COLOR_WHITE, false);
+        rp2040_oled_set_pixel(oled, 50, 0, OLED_COLOR_WHITE, false);
+        bench_expect(oled, "distant runs", 2, 1, 1);
+
+        rp2040_oled_draw_rectangle(oled, 0, PAGE_BITS, w - 1, 2 * PAGE_BITS - 1,
+                                   OLED_COLOR_WHITE, true, false);
+        bench_expect(oled, "full page", 1, w, 1);
+
+        /* horizontal addressing sends both pages through a single window */
+        if (h >= 4 * PAGE_BITS) {
+                rp2040_oled_draw_rectangle(oled, 0, 2 * PAGE_BITS, w - 1, 4 * PAGE_BITS - 1,
+                                           OLED_COLOR_WHITE, true, false);
+                if (oled->use_horizontal_addr)
+                        bench_expect(oled, "two pages", 1, w, 2);
+                else
+                        bench_expect(oled, "two pages", 2, w, 1);
+        }
+
+        rp2040_oled_clear(oled);
+        if (!rp2040_oled_mock_verify(oled)) {
+                printf("  counts clear: GDRAM mismatch\n");
+                failures++;
+        }
+}
+
+static void bench_scenes(rp2040_oled_t *oled)
+{
+        rp2040_oled_point_t points[64];
+        uint8_t w = oled->width;
+        uint8_t h = oled->height;
+
+        rp2040_oled_write_string(oled, 0, 0, "Hello", 5, false);
+        bench_flush(oled, "text");
+
+        rp2040_oled_draw_rectangle(oled, 2, 3, w / 2, h - 2, OLED_COLOR_WHITE, true, false);
+        rp2040_oled_draw_rectangle(oled, 4, 1, w - 3, h / 2, OLED_COLOR_XOR, false, false);
+        bench_flush(oled, "rectangles");
+
+        rp2040_oled_draw_line(oled, 0, 0, w - 1, h - 1, OLED_COLOR_INVERT, false);
+        rp2040_oled_draw_line(oled, w - 1, 0, 0, h - 1, OLED_COLOR_BLACK, false);
+        rp2040_oled_draw_line(oled, 0, h / 2, w - 1, h / 2, OLED_COLOR_AND_NOT, false);
+        bench_flush(oled, "lines");
+
+        rp2040_oled_draw_circle(oled, w / 2, h / 2, h / 3, OLED_COLOR_WHITE, false, false);
+        rp2040_oled_draw_ellipse(oled, w / 3, h / 3, w / 4, h / 4, OLED_COLOR_BLACK, true,
+                                 false);
+        rp2040_oled_draw_arc(oled, w / 2, h / 2, w / 3, h / 3, 30, 240, OLED_COLOR_WHITE,
+                             false);
+        bench_flush(oled, "curves");
+
+        for (size_t i = 0; i < sizeof(points) / sizeof(points[0]); i++) {
+                points[i].x = rand() % w;
+                points[i].y = rand() % h;
+        }
+        rp2040_oled_set_pixels(oled, points, sizeof(points) / sizeof(points[0]),
+                               OLED_COLOR_WHITE, false);
+        rp2040_oled_set_pixels_bitmap(oled, w - 10, 3, smiley, 8, 8, 1, OLED_COLOR_WHITE,
+                                      false);
+        bench_flush(oled, "pixels");
+
+        /* the same again only has to send what changed back */
+        rp2040_oled_set_pixels_bitmap(oled, w - 10, 3, smiley, 8, 8, 1, OLED_COLOR_BLACK,
+                                      false);
+        bench_flush(oled, "undraw");
+
+        rp2040_oled_scroll_vertical(oled, 1, false);
+        rp2040_oled_write_string(oled, 0, h - PAGE_BITS, "scrolled", 8, false);
+        bench_flush(oled, "scroll");
+
+        rp2040_oled_flush_async(oled, NULL, NULL);
+        if (!rp2040_oled_mock_verify(oled)) {
+                printf("  async: GDRAM mismatch\n");
+                failures++;
+        }
+
+        rp2040_oled_clear(oled);
+        if (!rp2040_oled_mock_verify(oled)) {
+                printf("  clear: GDRAM mismatch\n");
+                failures++;
+        }
+}
+
+static void bench_text(rp2040_oled_t *oled)
+{
+        static const char wrapped[] = "wrapped over more than one line";
+        rp2040_oled_rect_t rect = { 0, 0, oled->width / 2, oled->height };
+        rp2040_oled_glyph_cache_t cache = { 0 };
+        rp2040_oled_layout_t layout;
+
+        rp2040_oled_draw_text(oled, &rp2040_oled_font_8, -2, 3, "Clip", 4, OLED_COLOR_WHITE,
+                              false);
+        rp2040_oled_draw_text(oled, &rp2040_oled_font_16, oled->width - 20, 0, "Big", 3,
+                              OLED_COLOR_XOR, false);
+        bench_flush(oled, "draw text");
+
+        /* a code point the font lacks draws its fallback, XOR takes it off again */
+        rp2040_oled_clear(oled);
+        rp2040_oled_draw_text(oled, &rp2040_oled_font_8, 5, 2, "\xe2\x82\xac", 3,
+                              OLED_COLOR_WHITE, false);
+        bench_flush(oled, "utf-8 fallback");
+        bench_check(!bench_blank(oled), "utf-8 fallback drawn");
+        rp2040_oled_draw_text(oled, &rp2040_oled_font_8, 5, 2, "?", 1, OLED_COLOR_XOR, false);
+        bench_flush(oled, "utf-8 fallback xor");
+        bench_check(bench_blank(oled), "utf-8 fallback is '?'");
+
+        rp2040_oled_layout_text(&layout, &rp2040_oled_font_8, &rect, wrapped,
+                                sizeof(wrapped) - 1, OLED_ALIGN_CENTER);
+        bench_check(layout.line_count > 1, "layout wraps");
+        rp2040_oled_draw_layout(oled, &layout, OLED_COLOR_WHITE, false);
+        bench_flush(oled, "layout");
+
+        /* the same text at the same row within a page, uncached and from the cache */
+        rp2040_oled_clear(oled);
+        rp2040_oled_write_string(oled, 0, 3, "cache", 5, false);
+        bench_flush(oled, "uncached text");
+        memcpy(snapshot, oled->gdram, oled->gdram_size);
+
+        oled->glyph_cache = &cache;
+        rp2040_oled_clear(oled);
+        rp2040_oled_write_string(oled, 0, 3, "cache", 5, false);
+        rp2040_oled_clear(oled);
+        rp2040_oled_write_string(oled, 0, 3, "cache", 5, false);
+        bench_flush(oled, "cached text");
+        bench_check(cache.shift == 3 && !memcmp(snapshot, oled->gdram, oled->gdram_size),
+                    "glyph cache");
+        oled->glyph_cache = NULL;
+}
+
+static void bench_console(rp2040_oled_t *oled)
+{
+        uint8_t rows = oled->height / PAGE_BITS;
+        rp2040_oled_console_t console;
+
+        rp2040_oled_clear(oled);
+        rp2040_oled_console_init(&console, oled);
+
+        /* two lines more than fit, the ring wraps */
+        for (uint8_t i = 0; i < rows + 2; i++) {
+                char line[] = "line  ";
+
+                line[5] = '0' + i % 10;
+                rp2040_oled_console_write(&console, line, sizeof(line) - 1, true);
+                if (!rp2040_oled_mock_verify(oled)) {
+                        printf("  console: GDRAM mismatch\n");
+                        failures++;
+                }
+        }
+        bench_check(console.count == rows && console.head == 2 % rows, "console ring");
+
+        rp2040_oled_console_write(&console, "wraps after the last column of the panel",
+                                  40, true);
+        rp2040_oled_draw_rectangle(oled, 0, 0, oled->width - 1, oled->height - 1,
+                                   OLED_COLOR_WHITE, true, false);
+        rp2040_oled_console_redraw(&console, true);
+        bench_check(rp2040_oled_mock_verify(oled), "console redraw");
+}
+
+static void bench_sprites(rp2040_oled_t *oled)
+{
+        static uint8_t shifted[RP2040_OLED_SPRITE_SHIFTED_SIZE(8, 8)];
+        static uint8_t mask_shifted[RP2040_OLED_SPRITE_SHIFTED_SIZE(8, 8)];
+        rp2040_oled_sprite_t cached, plain;
+        uint8_t w = oled->width;
+
+        rp2040_oled_sprite_init(&cached, smiley, 8, 8, shifted);
+        rp2040_oled_sprite_set_mask(&cached, smiley_mask, mask_shifted);
+        rp2040_oled_sprite_init(&plain, smiley, 8, 8, NULL);
+        rp2040_oled_sprite_set_mask(&plain, smiley_mask, NULL);
+
+        /* over a filled background, the mask keeps the corners */
+        rp2040_oled_clear(oled);
+        rp2040_oled_draw_rectangle(oled, 0, 0, w - 1, 15, OLED_COLOR_WHITE, true, false);
+        rp2040_oled_blit_sprite(oled, &cached, 5, 3, OLED_COLOR_FULL_BYTE, false);
+        rp2040_oled_blit_sprite(oled, &plain, 20, 3, OLED_COLOR_FULL_BYTE, false);
+        rp2040_oled_blit_sprite(oled, &cached, -3, -2, OLED_COLOR_WHITE, false);
+        rp2040_oled_blit_sprite(oled, &plain, w - 5, 11, OLED_COLOR_BLACK, false);
+        bench_flush(oled, "masked blits");
+
+        /* pre-shifted and shifted on the fly come out the same */
+        for (uint8_t page = 0; page < 2; page++)
+                bench_check(!memcmp(oled->gdram + page * w + 5, oled->gdram + page * w + 20, 8),
+                            "shift cache");
+
+        /* raster ops applied twice leave the picture as it was */
+        memcpy(snapshot, oled->gdram, oled->gdram_size);
+        rp2040_oled_blit_sprite(oled, &cached, 30, 5, OLED_COLOR_XOR, false);
+        rp2040_oled_blit_sprite(oled, &plain, 40, 1, OLED_COLOR_INVERT, false);
+        bench_flush(oled, "xor/invert blits");
+        rp2040_oled_blit_sprite(oled, &cached, 30, 5, OLED_COLOR_XOR, false);
+        rp2040_oled_blit_sprite(oled, &plain, 40, 1, OLED_COLOR_INVERT, false);
+        bench_flush(oled, "xor/invert blits undone");
+        bench_check(!memcmp(snapshot, oled->gdram, oled->gdram_size), "raster ops");
+}
+
+static void bench_scrolling(rp2040_oled_t *oled)
+{
+        rp2040_oled_mock_t *mock = oled->transport_data;
+        rp2040_oled_framebuffer_t fb;
+
+        rp2040_oled_write_string(oled, 0, 0, "scroll", 6, false);
+
+        if (oled->type != OLED_SSD1306_3C && oled->type != OLED_SSD1306_3D) {
+                bench_check(!rp2040_oled_scroll_horizontal(oled, 0, 0, false,
+                                                           OLED_SCROLL_5_FRAMES),
+                            "hscroll needs an ssd1306");
+                return;
+        }
+
+        bench_check(rp2040_oled_scroll_horizontal(oled, 0, 0, false, OLED_SCROLL_5_FRAMES) &&
+                    mock->scrolling, "hscroll start");
+        /* the start line must not move while the controller rotates RAM */
+        bench_check(!rp2040_oled_scroll_vertical(oled, 1, true), "hscroll interlock");
+        bench_check(rp2040_oled_scroll_stop(oled, true) && !mock->scrolling, "hscroll stop");
+        bench_check(rp2040_oled_mock_verify(oled), "hscroll restore");
+
+        rp2040_oled_lock_framebuffer(oled, &fb);
+        bench_check(!rp2040_oled_scroll_horizontal(oled, 0, 0, true, OLED_SCROLL_2_FRAMES),
+                    "hscroll while locked");
+        rp2040_oled_unlock(oled, NULL);
+        bench_flush(oled, "hscroll unlock");
+}
+
+static void bench_lock(rp2040_oled_t *oled)
+{
+        rp2040_oled_mock_t *mock = oled->transport_data;
+        rp2040_oled_rect_t rect = { 0, 0, oled->width, 2 * PAGE_BITS };
+        rp2040_oled_framebuffer_t fb;
+
+        rp2040_oled_lock_framebuffer(oled, &fb);
+        rp2040_oled_mock_reset_stats(mock);
+
+        fb.data[3] = 0xa5;
+        fb.data[fb.stride + 9] = 0x5a;
+        rp2040_oled_draw_rectangle(oled, 12, 2, 30, 12, OLED_COLOR_INVERT, true, true);
+        rp2040_oled_flush(oled);
+        bench_check(mock->transactions == 0, "nothing sent while locked");
+
+        rp2040_oled_unlock(oled, &rect);
+        bench_flush(oled, "unlock");
+        bench_check(oled->gdram[3] == 0xa5, "direct framebuffer write");
+}
+
+static void bench_features(rp2040_oled_t *oled)
+{
+        bench_text(oled);
+        bench_console(oled);
+        bench_sprites(oled);
+        bench_scrolling(oled);
+        bench_lock(oled);
+}
+
+static void bench_run(const bench_panel_t *panel, const bench_mode_t *mode)
+{
+        rp2040_oled_mock_t mock;
+        rp2040_oled_t oled = {
+                .transport           = &rp2040_oled_mock_transport,
+                .transport_data      = &mock,
+                .size                = panel->size,
+                .use_doublebuf       = mode->use_doublebuf,
+                .use_horizontal_addr = mode->use_horizontal_addr,
+                .max_transfer        = mode->max_transfer,
+        };
+
+        rp2040_oled_mock_init(&mock, panel->type);
+        oled.addr = mock.addr;
+
+        if (mode->use_arena) {
+                oled.arena = arena;
+                oled.arena_size = sizeof(arena);
+                oled.dirty_buf = arena_dirty;
+
+                /* the word-wise diff needs aligned frame buffers */
+                oled.gdram = arena_gdram + 1;
+                bench_check(rp2040_oled_init(&oled) == OLED_NOT_FOUND, "misaligned gdram");
+                oled.gdram = arena_gdram;
+        }
+
+        if (rp2040_oled_init(&oled) == OLED_NOT_FOUND) {
+                printf("%-15s: init failed\n", panel->name);
+                failures++;
+                return;
+        }
+
+        /* only the SSD1306 addresses horizontally, elsewhere this repeats a run */
+        if (mode->use_horizontal_addr && !oled.use_horizontal_addr)
+                goto out;
+
+        if (!rp2040_oled_mock_verify(&oled)) {
+                printf("%-15s: GDRAM mismatch after init\n", panel->name);
+                failures++;
+        }
+
+        bench_counts(&oled);
+
+        srand(1);
+        rp2040_oled_mock_reset_stats(&mock);
+        bench_scenes(&oled);
+
+        printf("%-15s dbuf %d haddr %d max %3u arena %d: %5zu transactions %6zu bytes "
+               "(%5zu cmd %6zu data)\n", panel->name, mode->use_doublebuf,
+               mode->use_horizontal_addr, mode->max_transfer, mode->use_arena,
+               mock.transactions, mock.bytes, mock.cmd_bytes, mock.data_bytes);
+
+        bench_features(&oled);
+
+out:
+        if (!mode->use_arena) {
+                free(oled.gdram);
+                free(oled.dirty_buf);
+        }
+}
+
+int main(void)
+{
+        for (size_t p = 0; p < sizeof(panels) / sizeof(panels[0]); p++)
+                for (size_t m = 0; m < sizeof(modes) / sizeof(modes[0]); m++)
+                        bench_run(&panels[p], &modes[m]);
+
+        printf("%s\n", failures ? "FAILED" : "OK");
+
+        return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}